@@ -0,0 +1,47 @@
+//
+//  Asset.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef Asset_hpp
+#define Asset_hpp
+
+#include <future>
+#include <optional>
+#include <chrono>
+#include <cassert>
+
+// something being loaded in the background (e.g. on a ThreadPool), which can be checked on each
+// frame without waiting for it
+template <typename T>
+class Asset
+{
+public:
+    Asset(std::future<T>&& future):
+        future(std::move(future))
+    {}
+    Asset(const Asset&) = delete;
+    Asset& operator=(const Asset&) = delete;
+    // (if loading failed, rethrows the exception it failed with)
+    bool IsReady()
+    {
+        if (!value && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            value.emplace(future.get());
+        return value.has_value();
+    }
+    // (only once ready)
+    T& Get()
+    {
+        assert(value);
+        return *value;
+    }
+    
+private:
+    std::future<T> future;
+    std::optional<T> value;
+};
+
+#endif /* Asset_hpp */
@@ -0,0 +1,220 @@
+//
+//  BC1Surface.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include "BC1Surface.hpp"
+#include "Utils.hpp"
+
+BC1Surface::BC1Surface(const Surface& s):
+    w(s.Width()),
+    h(s.Height()),
+    blocksX((w + BlockDim - 1) / BlockDim),
+    blocksY((h + BlockDim - 1) / BlockDim),
+    id(NextId())
+{
+    std::shared_ptr<uint64_t[]> pNewBlocks(new uint64_t[blocksX * blocksY]);
+    
+    unsigned int texels[BlockDim * BlockDim];
+    for (int by = 0; by < blocksY; by++)
+    {
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            // partial blocks at the right/bottom edges repeat the last column/row
+            for (int y = 0; y < BlockDim; y++)
+                for (int x = 0; x < BlockDim; x++)
+                    texels[y * BlockDim + x] = s.GetPixel(std::min(bx * BlockDim + x, w - 1),
+                                                          std::min(by * BlockDim + y, h - 1));
+            
+            pNewBlocks[by * blocksX + bx] = EncodeBlock(texels);
+        }
+    }
+    
+    pBlocks = std::move(pNewBlocks);
+}
+
+BC1Surface::BC1Surface(int w, int h, std::shared_ptr<const uint64_t[]> pBlocks):
+    w(w),
+    h(h),
+    blocksX((w + BlockDim - 1) / BlockDim),
+    blocksY((h + BlockDim - 1) / BlockDim),
+    pBlocks(std::move(pBlocks)),
+    id(NextId())
+{
+}
+
+Color BC1Surface::GetPixel(int x, int y) const
+{
+    assert(x >= 0);
+    assert(y >= 0);
+    assert(x < w);
+    assert(y < h);
+    const unsigned int* pTexels = GetDecodedBlock(x / BlockDim, y / BlockDim);
+    return pTexels[(y % BlockDim) * BlockDim + (x % BlockDim)];
+}
+
+Color BC1Surface::GetPixelUV(float u, float v) const
+{
+    assert(u >= 0.0f);
+    assert(v >= 0.0f);
+    assert(u <= 1.0f);
+    assert(v <= 1.0f);
+    
+    int x = static_cast<int>(u * static_cast<float>(w));
+    int y = static_cast<int>(v * static_cast<float>(h));
+    Utils::Clamp(x, 0, w - 1);
+    Utils::Clamp(y, 0, h - 1);
+    
+    return GetPixel(x, y);
+}
+
+Color BC1Surface::GetPixelUVBilinear(float u, float v) const
+{
+    assert(u >= 0.0f);
+    assert(v >= 0.0f);
+    assert(u <= 1.0f);
+    assert(v <= 1.0f);
+    
+    Surface::BilinearTap t = Surface::CalcBilinearTap(u, v, w, h);
+    return Surface::BlendBilinear(GetPixel(t.x0, t.y0), GetPixel(t.x1, t.y0),
+                                  GetPixel(t.x0, t.y1), GetPixel(t.x1, t.y1), t.fx, t.fy);
+}
+
+// (a direct-mapped cache, indexed by the low bits of the block index - offset by the surface's
+// id, so that e.g. the two mip levels trilinear filtering reads from don't keep evicting each
+// other's blocks)
+const unsigned int* BC1Surface::GetDecodedBlock(int blockX, int blockY) const
+{
+    thread_local CachedBlock cache[NumCachedBlocks];
+    
+    int blockIndex = blockY * blocksX + blockX;
+    CachedBlock& cb = cache[(static_cast<uint64_t>(blockIndex) + id * CacheOffset) % NumCachedBlocks];
+    if (cb.blockIndex != blockIndex || cb.surfaceId != id)
+    {
+        DecodeBlock(pBlocks[blockIndex], cb.texels);
+        cb.surfaceId = id;
+        cb.blockIndex = blockIndex;
+    }
+    return cb.texels;
+}
+
+// (ids start at 1, as 0 marks an empty cache entry)
+uint64_t BC1Surface::NextId()
+{
+    static std::atomic<uint64_t> nextId(1);
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+// block layout (little endian): endpoint color 0 (16 bits), endpoint color 1 (16 bits), then 2-bit
+// indices for the 16 pixels, row by row
+// this is a simple (fast, not best quality) encoder - the endpoints are the corners of the
+// bounding box of the block's colors, and each pixel gets the nearest of the 4 palette colors
+uint64_t BC1Surface::EncodeBlock(const unsigned int texels[16])
+{
+    int minR = 255, minG = 255, minB = 255;
+    int maxR = 0, maxG = 0, maxB = 0;
+    for (int i = 0; i < BlockDim * BlockDim; i++)
+    {
+        Color c = texels[i];
+        minR = std::min<int>(minR, c.R());
+        minG = std::min<int>(minG, c.G());
+        minB = std::min<int>(minB, c.B());
+        maxR = std::max<int>(maxR, c.R());
+        maxG = std::max<int>(maxG, c.G());
+        maxB = std::max<int>(maxB, c.B());
+    }
+    
+    uint16_t c0 = ToRGB565(Color(maxR, maxG, maxB));
+    uint16_t c1 = ToRGB565(Color(minR, minG, minB));
+    
+    // c0 > c1 selects the 4-color mode (the 3-color mode is only for transparency, which opaque
+    // images don't need) - if the endpoints are the same, every index is simply 0
+    if (c0 == c1)
+        return c0 | (static_cast<uint64_t>(c1) << 16);
+    if (c0 < c1)
+        std::swap(c0, c1);
+    
+    unsigned int palette[4];
+    CalcPalette(c0, c1, palette);
+    
+    uint64_t block = c0 | (static_cast<uint64_t>(c1) << 16);
+    for (int i = 0; i < BlockDim * BlockDim; i++)
+    {
+        Color c = texels[i];
+        int best = 0;
+        int bestDistSq = 0x7FFFFFFF;
+        for (int p = 0; p < 4; p++)
+        {
+            Color pc = palette[p];
+            int dr = c.R() - pc.R();
+            int dg = c.G() - pc.G();
+            int db = c.B() - pc.B();
+            int distSq = dr * dr + dg * dg + db * db;
+            if (distSq < bestDistSq)
+            {
+                bestDistSq = distSq;
+                best = p;
+            }
+        }
+        block |= static_cast<uint64_t>(best) << (32 + i * 2);
+    }
+    
+    return block;
+}
+
+void BC1Surface::DecodeBlock(uint64_t block, unsigned int texels[16])
+{
+    unsigned int palette[4];
+    CalcPalette(static_cast<uint16_t>(block), static_cast<uint16_t>(block >> 16), palette);
+    
+    uint32_t indices = static_cast<uint32_t>(block >> 32);
+    for (int i = 0; i < BlockDim * BlockDim; i++)
+    {
+        texels[i] = palette[indices & 0x3];
+        indices >>= 2;
+    }
+}
+
+void BC1Surface::CalcPalette(uint16_t c0, uint16_t c1, unsigned int palette[4])
+{
+    Color e0 = FromRGB565(c0);
+    Color e1 = FromRGB565(c1);
+    palette[0] = e0;
+    palette[1] = e1;
+    
+    if (c0 > c1)
+    {
+        // two colors a third and two thirds of the way between the endpoints
+        palette[2] = Color((2 * e0.R() + e1.R()) / 3, (2 * e0.G() + e1.G()) / 3, (2 * e0.B() + e1.B()) / 3);
+        palette[3] = Color((e0.R() + 2 * e1.R()) / 3, (e0.G() + 2 * e1.G()) / 3, (e0.B() + 2 * e1.B()) / 3);
+    }
+    else
+    {
+        // the 3-color mode - halfway between the endpoints, plus black (transparent)
+        palette[2] = Color((e0.R() + e1.R()) / 2, (e0.G() + e1.G()) / 2, (e0.B() + e1.B()) / 2);
+        palette[3] = Colors::Black;
+    }
+}
+
+uint16_t BC1Surface::ToRGB565(const Color& c)
+{
+    // (rounds to the nearest representable value)
+    return static_cast<uint16_t>(((c.R() * 31 + 127) / 255) << 11 |
+                                 ((c.G() * 63 + 127) / 255) << 5 |
+                                 ((c.B() * 31 + 127) / 255));
+}
+
+Color BC1Surface::FromRGB565(uint16_t c)
+{
+    // replicate the high bits into the low bits, so that e.g. full intensity maps to 255
+    unsigned int r = (c >> 11) & 0x1F;
+    unsigned int g = (c >> 5) & 0x3F;
+    unsigned int b = c & 0x1F;
+    return Color((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
@@ -0,0 +1,78 @@
+//
+//  BC1Surface.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef BC1Surface_hpp
+#define BC1Surface_hpp
+
+#include <memory>
+#include <cstdint>
+#include "Color.hpp"
+#include "Surface.hpp"
+
+// an opaque image compressed in the BC1 (a.k.a. DXT1) block format - each 4x4 block of pixels
+// is stored in 8 bytes, as two RGB565 endpoint colors plus a 2-bit index per pixel selecting
+// one of the endpoints or one of two colors in between them (4 bits per pixel, 1/8th the size
+// of 32-bit ARGB)
+// pixels stay compressed in memory and are decoded a block at a time when sampled - recently
+// decoded blocks are kept in a small cache, as neighboring lookups tend to hit the same blocks
+// (each thread has its own cache, shared by all the surfaces it samples, so a surface can be
+// sampled from any number of threads at once)
+class BC1Surface
+{
+public:
+    BC1Surface(const Surface& s);
+    // wraps blocks stored elsewhere (e.g. in a memory-mapped file), which are kept alive by the
+    // shared pointer's owner
+    BC1Surface(int w, int h, std::shared_ptr<const uint64_t[]> pBlocks);
+    BC1Surface(BC1Surface&) = delete;
+    BC1Surface(BC1Surface&& s) = default;
+    BC1Surface& operator=(BC1Surface&& s) = default;
+    int Width() const { return w; };
+    int Height() const { return h; };
+    size_t SizeBytes() const { return SizeBytes(w, h); }
+    static size_t SizeBytes(int w, int h)
+    {
+        return static_cast<size_t>((w + BlockDim - 1) / BlockDim) * ((h + BlockDim - 1) / BlockDim) * sizeof(uint64_t);
+    }
+    const uint64_t* GetBlockBuffer() const { return pBlocks.get(); }
+    Color GetPixel(int x, int y) const;
+    Color GetPixelUV(float u, float v) const;
+    Color GetPixelUVBilinear(float u, float v) const;
+    ~BC1Surface() = default;
+    
+private:
+    static uint64_t EncodeBlock(const unsigned int texels[16]);
+    static void DecodeBlock(uint64_t block, unsigned int texels[16]);
+    static void CalcPalette(uint16_t c0, uint16_t c1, unsigned int palette[4]);
+    static uint16_t ToRGB565(const Color& c);
+    static Color FromRGB565(uint16_t c);
+    const unsigned int* GetDecodedBlock(int blockX, int blockY) const;
+    
+    static constexpr int BlockDim = 4;
+    static constexpr int NumCachedBlocks = 64;
+    static constexpr uint64_t CacheOffset = 11;
+    
+    // (blocks are tagged with the surface they came from as well, by an id that is never reused -
+    // unlike an address, which a later surface might end up with)
+    struct CachedBlock
+    {
+        uint64_t surfaceId = 0;
+        int blockIndex = -1;
+        unsigned int texels[BlockDim * BlockDim];
+    };
+    static uint64_t NextId();
+    
+    int w;
+    int h;
+    int blocksX;
+    int blocksY;
+    std::shared_ptr<const uint64_t[]> pBlocks;
+    uint64_t id;
+};
+
+#endif /* BC1Surface_hpp */
@@ -0,0 +1,76 @@
+//
+//  BoundingBox.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef BoundingBox_hpp
+#define BoundingBox_hpp
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "Vec3.hpp"
+#include "Mat3.hpp"
+
+// an axis-aligned box around a set of points (e.g. a mesh's vertices, in model space) - an empty
+// box has min above max, and grows to fit whatever is added to it
+class BoundingBox
+{
+public:
+    BoundingBox() = default;
+    BoundingBox(const Vec3& min, const Vec3& max):
+        min(min),
+        max(max)
+    {}
+    static BoundingBox FromPoints(const std::vector<Vec3>& points)
+    {
+        BoundingBox b;
+        for (const auto& p : points)
+            b.Add(p);
+        return b;
+    }
+    void Add(const Vec3& p)
+    {
+        min = Vec3(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+        max = Vec3(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+    }
+    bool IsEmpty() const { return min.x > max.x; }
+    // (adding an empty box leaves this one as it is - rather than its min and max, which are
+    // inside out, stretching this one across all of space)
+    void Add(const BoundingBox& b)
+    {
+        if (b.IsEmpty())
+            return;
+        Add(b.min);
+        Add(b.max);
+    }
+    Vec3 Center() const { return (min + max) * 0.5f; }
+    // (half the size along each axis)
+    Vec3 Extents() const { return (max - min) * 0.5f; }
+    // (the 8 corners, numbered by bit: bit 0 picks max x, bit 1 max y and bit 2 max z)
+    Vec3 Corner(int i) const
+    {
+        return Vec3((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+    }
+    // the box around this one, rotated and then translated as a vertex shader would (each
+    // axis of the new box spans the rotated extents along it, so no corners need transforming)
+    BoundingBox Transformed(const Mat3& rotMat, const Vec3& transVec) const
+    {
+        Vec3 c = Center() * rotMat + transVec;
+        Vec3 e = Extents();
+        Vec3 r;
+        r.x = e.x * fabsf(rotMat.data[0][0]) + e.y * fabsf(rotMat.data[1][0]) + e.z * fabsf(rotMat.data[2][0]);
+        r.y = e.x * fabsf(rotMat.data[0][1]) + e.y * fabsf(rotMat.data[1][1]) + e.z * fabsf(rotMat.data[2][1]);
+        r.z = e.x * fabsf(rotMat.data[0][2]) + e.y * fabsf(rotMat.data[1][2]) + e.z * fabsf(rotMat.data[2][2]);
+        return BoundingBox(c - r, c + r);
+    }
+
+    Vec3 min = Vec3(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    Vec3 max = Vec3(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+};
+
+#endif /* BoundingBox_hpp */
@@ -0,0 +1,49 @@
+//
+//  BoundingSphere.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef BoundingSphere_hpp
+#define BoundingSphere_hpp
+
+#include <vector>
+#include <algorithm>
+#include "Vec3.hpp"
+#include "Mat3.hpp"
+#include "BoundingBox.hpp"
+
+// a sphere around a set of points (e.g. a mesh's vertices, in model space) - unlike a
+// BoundingBox, it stays just as tight however the mesh is rotated
+class BoundingSphere
+{
+public:
+    BoundingSphere() = default;
+    BoundingSphere(const Vec3& center, float radius):
+        center(center),
+        radius(radius)
+    {}
+    // (centered on the points' bounding box, which is not the smallest sphere around them, but
+    // is close for the sorts of shapes meshes usually are)
+    static BoundingSphere FromPoints(const std::vector<Vec3>& points)
+    {
+        if (points.empty())
+            return BoundingSphere();
+        BoundingSphere s(BoundingBox::FromPoints(points).Center(), 0.0f);
+        for (const auto& p : points)
+            s.radius = std::max(s.radius, (p - s.center).Mag());
+        return s;
+    }
+    // (rotated and then translated as a vertex shader would - the rotation must not scale)
+    BoundingSphere Transformed(const Mat3& rotMat, const Vec3& transVec) const
+    {
+        return BoundingSphere(center * rotMat + transVec, radius);
+    }
+
+    Vec3 center = Vec3(0.0f, 0.0f, 0.0f);
+    float radius = 0.0f;
+};
+
+#endif /* BoundingSphere_hpp */
@@ -0,0 +1,119 @@
+//
+//  Bvh.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <numeric>
+#include "Bvh.hpp"
+
+void Bvh::Build(const std::vector<BoundingBox>& bounds)
+{
+    nodes.clear();
+    objects.resize(bounds.size());
+    std::iota(objects.begin(), objects.end(), size_t(0));
+    if (!bounds.empty())
+        BuildNode(0, bounds.size(), bounds);
+
+    boxes.resize(bounds.size());
+    for (size_t k = 0; k < objects.size(); k++)
+        boxes[k] = bounds[objects[k]];
+}
+
+// (nodes are added depth first, so a node's first child always comes straight after it)
+void Bvh::BuildNode(size_t first, size_t count, const std::vector<BoundingBox>& bounds)
+{
+    const size_t i = nodes.size();
+    nodes.push_back({ BoundingBox(), first, count, 0, count <= MaxLeafObjects });
+
+    BoundingBox centers;
+    for (size_t k = first; k < first + count; k++)
+    {
+        nodes[i].box.Add(bounds[objects[k]]);
+        // (an empty box has no center - it's split off with whichever objects it happens to
+        // end up next to, which makes no difference, as it's never visible)
+        if (!bounds[objects[k]].IsEmpty())
+            centers.Add(bounds[objects[k]].Center());
+    }
+    if (nodes[i].leaf)
+        return;
+
+    // (split at the median, rather than halfway along the side, so the tree is always balanced
+    // however the objects are spread out)
+    Vec3 size = centers.max - centers.min;
+    auto axisOf = [](const Vec3& v, int axis) { return (axis == 0) ? v.x : (axis == 1) ? v.y : v.z; };
+    int axis = (size.x >= size.y && size.x >= size.z) ? 0 : (size.y >= size.z) ? 1 : 2;
+    size_t half = count / 2;
+    std::nth_element(objects.begin() + first, objects.begin() + first + half, objects.begin() + first + count,
+                     [&](size_t a, size_t b) { return axisOf(bounds[a].Center(), axis) < axisOf(bounds[b].Center(), axis); });
+
+    BuildNode(first, half, bounds);
+    nodes[i].second = nodes.size();
+    BuildNode(first + half, count - half, bounds);
+}
+
+// (children always come after their parents, so working backwards through the nodes updates
+// both of a node's children before it)
+void Bvh::Refit(const std::vector<BoundingBox>& bounds)
+{
+    for (size_t k = 0; k < objects.size(); k++)
+        boxes[k] = bounds[objects[k]];
+
+    for (size_t i = nodes.size(); i-- > 0; )
+    {
+        Node& n = nodes[i];
+        n.box = BoundingBox();
+        if (n.leaf)
+        {
+            for (size_t k = n.first; k < n.first + n.count; k++)
+                n.box.Add(boxes[k]);
+        }
+        else
+        {
+            n.box.Add(nodes[i + 1].box);
+            n.box.Add(nodes[n.second].box);
+        }
+    }
+}
+
+// walks down the tree, only going into the nodes that are partly inside the frustum - a node
+// entirely inside has all of its objects taken at once (which are next to each other in objects)
+void Bvh::FindVisible(const Frustum& frustum, std::vector<size_t>& visible) const
+{
+    visible.clear();
+    if (nodes.empty())
+        return;
+
+    // (the tree is balanced, so is never anywhere near this deep)
+    size_t stack[64];
+    size_t numStacked = 0;
+    size_t i = 0;
+    while (true)
+    {
+        const Node& n = nodes[i];
+        Frustum::Result res = frustum.Classify(n.box);
+        if (res == Frustum::Result::Inside)
+        {
+            visible.insert(visible.end(), objects.begin() + n.first, objects.begin() + n.first + n.count);
+        }
+        else if (res == Frustum::Result::Intersecting)
+        {
+            if (!n.leaf)
+            {
+                stack[numStacked++] = n.second;
+                i++;
+                continue;
+            }
+            for (size_t k = n.first; k < n.first + n.count; k++)
+                if (frustum.Classify(boxes[k]) != Frustum::Result::Outside)
+                    visible.push_back(objects[k]);
+        }
+
+        if (numStacked == 0)
+            break;
+        i = stack[--numStacked];
+    }
+}
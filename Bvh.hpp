@@ -0,0 +1,62 @@
+//
+//  Bvh.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef Bvh_hpp
+#define Bvh_hpp
+
+#include <vector>
+#include <cstddef>
+#include "BoundingBox.hpp"
+#include "Frustum.hpp"
+
+// a bounding volume hierarchy over a scene's objects - a tree of boxes, each around the objects
+// below it - so that finding the objects on screen can throw out whole groups of them at once
+// (a group entirely off screen is skipped without looking at anything in it, and one entirely on
+// screen is taken without testing anything more)
+// objects are identified by their index in the bounds the tree was built from, which are in
+// camera space (see BoundingBox::Transformed())
+class Bvh
+{
+public:
+    // (the most objects a leaf is left with, as testing a few boxes is quicker than going
+    // further down the tree for them)
+    static constexpr size_t MaxLeafObjects = 4;
+
+    // builds the tree from scratch, splitting the objects in half at each level, across the
+    // longest side of the box around their centers
+    void Build(const std::vector<BoundingBox>& bounds);
+    // updates the boxes after objects have moved, keeping the tree as it is - much quicker than
+    // rebuilding it, though the tree gets looser as objects move further from where it was built
+    void Refit(const std::vector<BoundingBox>& bounds);
+    // the objects that are at least partly inside the frustum (in no particular order)
+    void FindVisible(const Frustum& frustum, std::vector<size_t>& visible) const;
+    // (true if there's nothing in the tree, e.g. before it's first built)
+    bool IsEmpty() const { return nodes.empty(); }
+
+private:
+    // the objects below a node are objects[first] up to (but not including) objects[first +
+    // count] - and its children (unless it's a leaf) are the node straight after it and the one
+    // at second
+    struct Node
+    {
+        BoundingBox box;
+        size_t first;
+        size_t count;
+        size_t second;
+        bool leaf;
+    };
+
+    void BuildNode(size_t first, size_t count, const std::vector<BoundingBox>& bounds);
+
+    std::vector<Node> nodes;
+    std::vector<size_t> objects;
+    // (each object's bounds, in the same order as objects, so leaves test them in order)
+    std::vector<BoundingBox> boxes;
+};
+
+#endif /* Bvh_hpp */
@@ -45,6 +45,28 @@ public:
         *this = *this * n;
         return *this;
     }
+    
+    // fixed-point versions of the above, which avoid converting each component to and from
+    // float - scales are 8.8 fixed point (256 = 1.0) and results are rounded to nearest
+    // (also see ColorOps, for whole spans of pixels at once)
+    static constexpr unsigned int FixedOne = 256;
+    static constexpr unsigned int ToFixed(float n)
+    {
+        return (n <= 0.0f) ? 0 : (n >= 1.0f) ? FixedOne : static_cast<unsigned int>(n * FixedOne + 0.5f);
+    }
+    // (both red and blue are scaled with a single multiply, as there is room for each product
+    // between them)
+    constexpr Color Scaled(unsigned int scale) const
+    {
+        return Color((((argb & 0x00FF00FF) * scale + 0x00800080) >> 8 & 0x00FF00FF) |
+                     (((argb & 0x0000FF00) * scale + 0x00008000) >> 8 & 0x0000FF00));
+    }
+    // (t is 8.8 fixed point, from 0 = a to 256 = b)
+    static constexpr Color Lerp(Color a, Color b, unsigned int t)
+    {
+        return Color((((a.argb & 0x00FF00FF) * (FixedOne - t) + (b.argb & 0x00FF00FF) * t + 0x00800080) >> 8 & 0x00FF00FF) |
+                     (((a.argb & 0x0000FF00) * (FixedOne - t) + (b.argb & 0x0000FF00) * t + 0x00008000) >> 8 & 0x0000FF00));
+    }
     void SetRGB(unsigned char r, unsigned char g, unsigned char b)
     {
         argb = 0x00000000 |
@@ -70,7 +92,7 @@ public:
     {
         return ((argb & 0x000000FF));
     }
-    Vec3 Vec()
+    Vec3 Vec() const
     {
         return Vec3(static_cast<float>(R()),
                     static_cast<float>(G()),
@@ -0,0 +1,299 @@
+//
+//  ColorOps.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include "ColorOps.hpp"
+#include "Simd.hpp"
+
+// the vector versions all work the same way - the bytes of each pixel are widened to 16-bit
+// lanes, worked on there (where there is room for the products), and narrowed back again
+
+void ColorOps::Scale(const unsigned int* pIn, unsigned int scale, unsigned int* pOut, int n)
+{
+    int i = 0;
+#if SIMD_AVX2
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i rgbMask = _mm256_set1_epi32(0x00FFFFFF);
+        const __m256i half = _mm256_set1_epi16(128);
+        const __m256i s = _mm256_set1_epi16(static_cast<short>(scale));
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i c = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIn + i)), rgbMask);
+            __m256i lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(c, zero), s), half), 8);
+            __m256i hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(c, zero), s), half), 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), _mm256_packus_epi16(lo, hi));
+        }
+    }
+#endif
+#if SIMD_SSE2
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+        const __m128i half = _mm_set1_epi16(128);
+        const __m128i s = _mm_set1_epi16(static_cast<short>(scale));
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i c = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i)), rgbMask);
+            __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), s), half), 8);
+            __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), s), half), 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_packus_epi16(lo, hi));
+        }
+    }
+#endif
+    for (; i < n; i++)
+        pOut[i] = Color(pIn[i]).Scaled(scale);
+}
+
+void ColorOps::Modulate(const unsigned int* pA, const unsigned int* pB, unsigned int* pOut, int n)
+{
+    int i = 0;
+#if SIMD_AVX2
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i rgbMask = _mm256_set1_epi32(0x00FFFFFF);
+        const __m256i half = _mm256_set1_epi16(128);
+        auto mulDiv255 = [&](__m256i a, __m256i b)
+        {
+            __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(a, b), half);
+            return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+        };
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pA + i)), rgbMask);
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pB + i));
+            __m256i lo = mulDiv255(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+            __m256i hi = mulDiv255(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), _mm256_packus_epi16(lo, hi));
+        }
+    }
+#endif
+#if SIMD_SSE2
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+        const __m128i half = _mm_set1_epi16(128);
+        auto mulDiv255 = [&](__m128i a, __m128i b)
+        {
+            __m128i x = _mm_add_epi16(_mm_mullo_epi16(a, b), half);
+            return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+        };
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i)), rgbMask);
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i));
+            __m128i lo = mulDiv255(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = mulDiv255(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_packus_epi16(lo, hi));
+        }
+    }
+#endif
+    for (; i < n; i++)
+        pOut[i] = Modulate(pA[i], pB[i]);
+}
+
+// (saturating byte adds need no widening)
+void ColorOps::Add(const unsigned int* pA, const unsigned int* pB, unsigned int* pOut, int n)
+{
+    int i = 0;
+#if SIMD_AVX2
+    {
+        const __m256i rgbMask = _mm256_set1_epi32(0x00FFFFFF);
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pA + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pB + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), _mm256_and_si256(_mm256_adds_epu8(a, b), rgbMask));
+        }
+    }
+#endif
+#if SIMD_SSE2
+    {
+        const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_and_si128(_mm_adds_epu8(a, b), rgbMask));
+        }
+    }
+#endif
+    for (; i < n; i++)
+        pOut[i] = Add(pA[i], pB[i]);
+}
+
+// (a * (256 - t) + b * t never needs more than 16 bits)
+void ColorOps::Lerp(const unsigned int* pA, const unsigned int* pB, unsigned int t, unsigned int* pOut, int n)
+{
+    int i = 0;
+#if SIMD_AVX2
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i rgbMask = _mm256_set1_epi32(0x00FFFFFF);
+        const __m256i half = _mm256_set1_epi16(128);
+        const __m256i ta = _mm256_set1_epi16(static_cast<short>(Color::FixedOne - t));
+        const __m256i tb = _mm256_set1_epi16(static_cast<short>(t));
+        auto blend = [&](__m256i a, __m256i b)
+        {
+            __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(a, ta), _mm256_mullo_epi16(b, tb));
+            return _mm256_srli_epi16(_mm256_add_epi16(x, half), 8);
+        };
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pA + i)), rgbMask);
+            __m256i b = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pB + i)), rgbMask);
+            __m256i lo = blend(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+            __m256i hi = blend(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), _mm256_packus_epi16(lo, hi));
+        }
+    }
+#endif
+#if SIMD_SSE2
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+        const __m128i half = _mm_set1_epi16(128);
+        const __m128i ta = _mm_set1_epi16(static_cast<short>(Color::FixedOne - t));
+        const __m128i tb = _mm_set1_epi16(static_cast<short>(t));
+        auto blend = [&](__m128i a, __m128i b)
+        {
+            __m128i x = _mm_add_epi16(_mm_mullo_epi16(a, ta), _mm_mullo_epi16(b, tb));
+            return _mm_srli_epi16(_mm_add_epi16(x, half), 8);
+        };
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i)), rgbMask);
+            __m128i b = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i)), rgbMask);
+            __m128i lo = blend(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = blend(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_packus_epi16(lo, hi));
+        }
+    }
+#endif
+    for (; i < n; i++)
+        pOut[i] = Color::Lerp(pA[i], pB[i], t);
+}
+
+void ColorOps::Pack(const float* pR, const float* pG, const float* pB, unsigned int* pOut, int n)
+{
+    int i = 0;
+#if SIMD_AVX2
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 max = _mm256_set1_ps(255.0f);
+        auto toChannel = [&](const float* p)
+        {
+            return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(p), zero), max));
+        };
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i c = _mm256_or_si256(_mm256_slli_epi32(toChannel(pR + i), 16), _mm256_slli_epi32(toChannel(pG + i), 8));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), _mm256_or_si256(c, toChannel(pB + i)));
+        }
+    }
+#endif
+#if SIMD_SSE2
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 max = _mm_set1_ps(255.0f);
+        auto toChannel = [&](const float* p)
+        {
+            return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(p), zero), max));
+        };
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i c = _mm_or_si128(_mm_slli_epi32(toChannel(pR + i), 16), _mm_slli_epi32(toChannel(pG + i), 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_or_si128(c, toChannel(pB + i)));
+        }
+    }
+#endif
+    for (; i < n; i++)
+        pOut[i] = ToChannel(pR[i]) << 16 | ToChannel(pG[i]) << 8 | ToChannel(pB[i]);
+}
+
+void ColorOps::Ramp(const Vec3& start, const Vec3& step, unsigned int* pOut, int n)
+{
+    int r = ToFixed16(start.x);
+    int g = ToFixed16(start.y);
+    int b = ToFixed16(start.z);
+    const int dr = ToFixed16(step.x);
+    const int dg = ToFixed16(step.y);
+    const int db = ToFixed16(step.z);
+    
+    // (each vector of channels is narrowed with saturating packs - which also clamps them to
+    // 0-255 - to bytes of red, then green, then blue, and those are interleaved into pixels)
+    // (the channels are held within RampLimit after every step, as StepRamp() does - so a lane,
+    // once it's saturated, stays saturated - and carried on from the first lane afterwards)
+    int i = 0;
+#if SIMD_AVX2
+    if (n >= 8)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i limit = _mm256_set1_epi32(RampLimit), negLimit = _mm256_set1_epi32(-RampLimit);
+        auto hold = [&](__m256i v) { return _mm256_max_epi32(_mm256_min_epi32(v, limit), negLimit); };
+        auto ramp = [&](int c, int d) { return hold(_mm256_add_epi32(_mm256_set1_epi32(c), _mm256_mullo_epi32(lanes, _mm256_set1_epi32(d)))); };
+        __m256i vr = ramp(r, dr), vg = ramp(g, dg), vb = ramp(b, db);
+        const __m256i stepR = _mm256_set1_epi32(dr * 8), stepG = _mm256_set1_epi32(dg * 8), stepB = _mm256_set1_epi32(db * 8);
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i rg = _mm256_packs_epi32(_mm256_srai_epi32(vr, 16), _mm256_srai_epi32(vg, 16));
+            __m256i b0 = _mm256_packs_epi32(_mm256_srai_epi32(vb, 16), zero);
+            __m256i bytes = _mm256_packus_epi16(rg, b0);
+            __m256i bg = _mm256_unpacklo_epi8(_mm256_srli_si256(bytes, 8), _mm256_srli_si256(bytes, 4));
+            __m256i r0 = _mm256_unpacklo_epi8(bytes, zero);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), _mm256_unpacklo_epi16(bg, r0));
+            vr = hold(_mm256_add_epi32(vr, stepR));
+            vg = hold(_mm256_add_epi32(vg, stepG));
+            vb = hold(_mm256_add_epi32(vb, stepB));
+        }
+        r = _mm_cvtsi128_si32(_mm256_castsi256_si128(vr));
+        g = _mm_cvtsi128_si32(_mm256_castsi256_si128(vg));
+        b = _mm_cvtsi128_si32(_mm256_castsi256_si128(vb));
+    }
+#endif
+#if SIMD_SSE2
+    if (n - i >= 4)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i limit = _mm_set1_epi32(RampLimit), negLimit = _mm_set1_epi32(-RampLimit);
+        // (SSE2 has no 32-bit min or max, so lanes past the limit are picked out and replaced)
+        auto hold = [&](__m128i v)
+        {
+            __m128i over = _mm_cmpgt_epi32(v, limit);
+            v = _mm_or_si128(_mm_and_si128(over, limit), _mm_andnot_si128(over, v));
+            __m128i under = _mm_cmplt_epi32(v, negLimit);
+            return _mm_or_si128(_mm_and_si128(under, negLimit), _mm_andnot_si128(under, v));
+        };
+        auto ramp = [&](int c, int d) { return hold(_mm_setr_epi32(c, c + d, c + 2 * d, c + 3 * d)); };
+        __m128i vr = ramp(r, dr), vg = ramp(g, dg), vb = ramp(b, db);
+        const __m128i stepR = _mm_set1_epi32(dr * 4), stepG = _mm_set1_epi32(dg * 4), stepB = _mm_set1_epi32(db * 4);
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i rg = _mm_packs_epi32(_mm_srai_epi32(vr, 16), _mm_srai_epi32(vg, 16));
+            __m128i b0 = _mm_packs_epi32(_mm_srai_epi32(vb, 16), zero);
+            __m128i bytes = _mm_packus_epi16(rg, b0);
+            __m128i bg = _mm_unpacklo_epi8(_mm_srli_si128(bytes, 8), _mm_srli_si128(bytes, 4));
+            __m128i r0 = _mm_unpacklo_epi8(bytes, zero);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_unpacklo_epi16(bg, r0));
+            vr = hold(_mm_add_epi32(vr, stepR));
+            vg = hold(_mm_add_epi32(vg, stepG));
+            vb = hold(_mm_add_epi32(vb, stepB));
+        }
+        r = _mm_cvtsi128_si32(vr);
+        g = _mm_cvtsi128_si32(vg);
+        b = _mm_cvtsi128_si32(vb);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        pOut[i] = ToChannel(r) << 16 | ToChannel(g) << 8 | ToChannel(b);
+        r = StepRamp(r, dr);
+        g = StepRamp(g, dg);
+        b = StepRamp(b, db);
+    }
+}
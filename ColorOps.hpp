@@ -0,0 +1,92 @@
+//
+//  ColorOps.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef ColorOps_hpp
+#define ColorOps_hpp
+
+#include "Color.hpp"
+
+// color math on whole spans of packed (ARGB) pixels - the components are worked on as packed
+// integers, several pixels at once (8 with AVX2, 4 with SSE2), rather than being converted to
+// and from floats one pixel at a time
+// results match the single-pixel fixed-point operations in Color exactly, whichever instruction
+// set is used, and alpha comes out as 0 (as it does for Color's arithmetic)
+// (the output may be the same array as either input)
+class ColorOps
+{
+public:
+    ColorOps() = delete;
+    ~ColorOps() = delete;
+    
+    // scales each pixel by the same 8.8 fixed-point factor (see Color::Scaled())
+    static void Scale(const unsigned int* pIn, unsigned int scale, unsigned int* pOut, int n);
+    // multiplies pixels component by component, treating 255 as 1.0 (e.g. to tint a texture)
+    static void Modulate(const unsigned int* pA, const unsigned int* pB, unsigned int* pOut, int n);
+    // adds pixels component by component, saturating at 255
+    static void Add(const unsigned int* pA, const unsigned int* pB, unsigned int* pOut, int n);
+    // blends between pixels by the same 8.8 fixed-point amount (see Color::Lerp())
+    static void Lerp(const unsigned int* pA, const unsigned int* pB, unsigned int t, unsigned int* pOut, int n);
+    // packs pixels from separate arrays of float channels, where 255 is full intensity - values
+    // are truncated (as Color(const Vec3&) does), and clamped to 0-255
+    static void Pack(const float* pR, const float* pG, const float* pB, unsigned int* pOut, int n);
+    // fills pixels with colors stepped linearly from start, by step per pixel (channels as for
+    // Pack) - the channels are stepped as 16.16 fixed point, so no floats are converted per pixel
+    static void Ramp(const Vec3& start, const Vec3& step, unsigned int* pOut, int n);
+    
+    // single-pixel versions of the above, also used for the pixels left over after the last
+    // full vector
+    static constexpr unsigned int Modulate(unsigned int a, unsigned int b)
+    {
+        return MulDiv255((a >> 16) & 0xFF, (b >> 16) & 0xFF) << 16 |
+               MulDiv255((a >> 8) & 0xFF, (b >> 8) & 0xFF) << 8 |
+               MulDiv255(a & 0xFF, b & 0xFF);
+    }
+    static constexpr unsigned int Add(unsigned int a, unsigned int b)
+    {
+        return AddSat((a >> 16) & 0xFF, (b >> 16) & 0xFF) << 16 |
+               AddSat((a >> 8) & 0xFF, (b >> 8) & 0xFF) << 8 |
+               AddSat(a & 0xFF, b & 0xFF);
+    }
+    
+private:
+    // (rounded division by 255, without dividing)
+    static constexpr unsigned int MulDiv255(unsigned int a, unsigned int b)
+    {
+        return (a * b + 128 + ((a * b + 128) >> 8)) >> 8;
+    }
+    static constexpr unsigned int AddSat(unsigned int a, unsigned int b)
+    {
+        return (a + b > 255) ? 255 : a + b;
+    }
+    // (kept well inside the range of 16.16, so that several steps can be added at once without
+    // overflowing)
+    static int ToFixed16(float f)
+    {
+        f = (f < -512.0f) ? -512.0f : (f > 512.0f) ? 512.0f : f;
+        return static_cast<int>(f * 65536.0f);
+    }
+    // a ramp is held within RampLimit either way as it's stepped (past which it's saturated
+    // anyway), so that however long it runs, it never overflows
+    static constexpr int RampLimit = 1024 << 16;
+    static int StepRamp(int c, int d)
+    {
+        c += d;
+        return (c < -RampLimit) ? -RampLimit : (c > RampLimit) ? RampLimit : c;
+    }
+    static unsigned int ToChannel(int fixed16)
+    {
+        int c = fixed16 >> 16;
+        return (c < 0) ? 0 : (c > 255) ? 255 : static_cast<unsigned int>(c);
+    }
+    static unsigned int ToChannel(float f)
+    {
+        return !(f > 0.0f) ? 0 : (f >= 255.0f) ? 255 : static_cast<unsigned int>(f);
+    }
+};
+
+#endif /* ColorOps_hpp */
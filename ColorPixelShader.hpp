@@ -0,0 +1,40 @@
+//
+//  ColorPixelShader.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef ColorPixelShader_hpp
+#define ColorPixelShader_hpp
+
+#include <cstddef>
+#include "Color.hpp"
+#include "ColorOps.hpp"
+#include "Interpolants.hpp"
+
+// a pixel shader for effects whose color is worked out at the vertices (e.g. assigned to them,
+// or lit there) and simply interpolated across triangles - the color is the N attributes'
+// three starting at R, red, green and blue, where 255 is full intensity
+// rows are shaded a whole span at a time (see UsesSpans), or stepped in fixed point where
+// attributes are linear (see HasColorAttributes)
+template <size_t N, size_t R>
+class ColorPixelShader
+{
+public:
+    typedef InterpolantSpan<N> Span;
+    static constexpr size_t ColorAttribute = R;
+
+    Color operator()(const InterpolatedVertex<N>& inVertex)
+    {
+        return Color(inVertex.attr.GetVec3(R));
+    }
+    // (the same as above, for a whole row of pixels at once)
+    void operator()(const Span& attributes, const InterpolatedVertex<N>&, unsigned int* pOut, int n)
+    {
+        ColorOps::Pack(attributes[R], attributes[R + 1], attributes[R + 2], pOut, n);
+    }
+};
+
+#endif /* ColorPixelShader_hpp */
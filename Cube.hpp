@@ -14,6 +14,8 @@
 #include "Vec3.hpp"
 #include "IndexedLineList.hpp"
 #include "IndexedTriangleList.hpp"
+#include "BoundingBox.hpp"
+#include "BoundingSphere.hpp"
 #include "TextureEffect.hpp"
 #include "VertexColorEffect.hpp"
 
@@ -90,6 +92,9 @@ public:
         // ensure parallel vectors are of correct length
         assert(textureCoords.size() == vertices.size());
         assert(colors.size() == vertices.size());
+        
+        boundingBox = BoundingBox::FromPoints(vertices);
+        boundingSphere = BoundingSphere::FromPoints(vertices);
     }
     IndexedLineList GetIndexedLineList()
     {
@@ -115,6 +120,9 @@ public:
         
         return { verticesVC, triangles };
     }
+    // (around the model space vertices, worked out once when the mesh is built)
+    const BoundingBox& GetBoundingBox() const { return boundingBox; }
+    const BoundingSphere& GetBoundingSphere() const { return boundingSphere; }
     
 private:
     std::vector<Vec3> vertices;
@@ -122,6 +130,8 @@ private:
     std::vector<IndexedTriangle> triangles;
     std::vector<Vec2> textureCoords;
     std::vector<Color> colors;
+    BoundingBox boundingBox;
+    BoundingSphere boundingSphere;
 };
 
 #endif /* Cube_hpp */
@@ -0,0 +1,126 @@
+//
+//  CubeField.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef CubeField_hpp
+#define CubeField_hpp
+
+#include <vector>
+#include "Vec3.hpp"
+#include "IndexedTriangleList.hpp"
+#include "BoundingBox.hpp"
+#include "MeshStreams.hpp"
+#include "FlatShadingEffect.hpp"
+#include "Cube.hpp"
+
+// a scene of many small cubes laid out in a grid, with a few long walls of tall blocks running
+// across it - from most angles, most of the cubes are either off screen or hidden behind the
+// walls, so only the few that can actually be seen should be drawn (see Game::DrawField())
+// everything is positioned around the field's center, which the whole field is rotated about
+// (each object fills one cell of the grid, so drawing them from the furthest cell to the
+// nearest draws them in the right order)
+class CubeField
+{
+public:
+    enum class Kind
+    {
+        Cube,
+        Block,
+        NumKinds
+    };
+    struct Object
+    {
+        Kind kind;
+        // (the center of the object's cell, relative to the field's center)
+        Vec3 position;
+    };
+
+    static constexpr int CellsPerSide = 32;
+    static constexpr float Spacing = 1.5f;
+    static constexpr float WallHeight = 3.0f;
+    // (the furthest anything is from the center)
+    static constexpr float Radius = 35.0f;
+
+    CubeField()
+    {
+        Cube c;
+        IndexedTriangleList<Vec3> unitCube = c.GetIndexedTriangleList();
+
+        // (blocks stand on the same ground as cubes, but fill their whole cell)
+        AddBox(meshes[static_cast<int>(Kind::Cube)], Vec3(0.0f, 0.0f, 0.0f), Vec3(1.0f, 1.0f, 1.0f), unitCube);
+        AddBox(meshes[static_cast<int>(Kind::Block)], Vec3(0.0f, 0.5f * WallHeight - 0.5f, 0.0f),
+               Vec3(Spacing, WallHeight, Spacing), unitCube);
+        for (int k = 0; k < static_cast<int>(Kind::NumKinds); k++)
+        {
+            streams[k].Assign(meshes[k].vertices);
+            for (const auto& v : meshes[k].vertices)
+                boxes[k].Add(v.v);
+        }
+
+        for (int z = 0; z < CellsPerSide; z++)
+        {
+            for (int x = 0; x < CellsPerSide; x++)
+            {
+                Kind kind = (IsWall(x) || IsWall(z)) ? Kind::Block : Kind::Cube;
+                objects.push_back({ kind, Vec3(CellCenter(x), 0.0f, CellCenter(z)) });
+            }
+        }
+
+        // the walls as the occlusion buffer sees them - one long box each, rather than a block
+        // per cell
+        const float length = Spacing * static_cast<float>(CellsPerSide);
+        for (int k : WallCells)
+        {
+            AddBox(occluders, Vec3(0.0f, 0.5f * WallHeight - 0.5f, CellCenter(k)), Vec3(length, WallHeight, Spacing), unitCube);
+            AddBox(occluders, Vec3(CellCenter(k), 0.5f * WallHeight - 0.5f, 0.0f), Vec3(Spacing, WallHeight, length), unitCube);
+        }
+        occluderStreams.Assign(occluders.vertices);
+    }
+    const std::vector<Object>& GetObjects() const { return objects; }
+    // every object of a kind is the same mesh, drawn at each object's position
+    const IndexedTriangleList<FlatShadingEffect::Vertex>& GetMesh(Kind kind) const { return meshes[static_cast<int>(kind)]; }
+    const MeshStreams& GetStreams(Kind kind) const { return streams[static_cast<int>(kind)]; }
+    // (around the mesh, in model space)
+    const BoundingBox& GetBoundingBox(Kind kind) const { return boxes[static_cast<int>(kind)]; }
+    // (around the field's center)
+    const IndexedTriangleList<FlatShadingEffect::Vertex>& GetOccluders() const { return occluders; }
+    const MeshStreams& GetOccluderStreams() const { return occluderStreams; }
+
+private:
+    static constexpr int WallCells[] = { 7, 15, 23 };
+
+    static float CellCenter(int i)
+    {
+        return Spacing * (static_cast<float>(i) - 0.5f * static_cast<float>(CellsPerSide - 1));
+    }
+    static bool IsWall(int i)
+    {
+        for (int k : WallCells)
+            if (i == k)
+                return true;
+        return false;
+    }
+    // (the unit cube, stretched to the given size and then moved to the given center)
+    static void AddBox(IndexedTriangleList<FlatShadingEffect::Vertex>& itl, const Vec3& center, const Vec3& size,
+                       const IndexedTriangleList<Vec3>& unitCube)
+    {
+        size_t firstVertex = itl.vertices.size();
+        for (const auto& v : unitCube.vertices)
+            itl.vertices.emplace_back(Vec3(v.x * size.x, v.y * size.y, v.z * size.z) + center);
+        for (const auto& t : unitCube.triangles)
+            itl.triangles.push_back({ { t.indices[0] + firstVertex, t.indices[1] + firstVertex, t.indices[2] + firstVertex } });
+    }
+
+    IndexedTriangleList<FlatShadingEffect::Vertex> meshes[static_cast<int>(Kind::NumKinds)];
+    MeshStreams streams[static_cast<int>(Kind::NumKinds)];
+    BoundingBox boxes[static_cast<int>(Kind::NumKinds)];
+    std::vector<Object> objects;
+    IndexedTriangleList<FlatShadingEffect::Vertex> occluders;
+    MeshStreams occluderStreams;
+};
+
+#endif /* CubeField_hpp */
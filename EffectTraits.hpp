@@ -0,0 +1,110 @@
+//
+//  EffectTraits.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef EffectTraits_hpp
+#define EffectTraits_hpp
+
+#include <type_traits>
+#include <utility>
+
+// the optional capabilities and shortcuts an effect's shaders can declare, with static constexpr
+// bool members - the pipeline checks these at compile time, so that work an effect doesn't
+// need isn't even compiled into its pipeline
+// (a shader that doesn't declare a member gets the default, i.e. the general case)
+
+// a pixel shader can ask for the screen-space derivatives of its input attributes (e.g. for
+// texture level of detail selection) by declaring a UsesDerivatives member that is true - in
+// which case it is called as pixelShader(vertex, ddx, ddy)
+template <typename PixelShader, typename = void>
+struct UsesDerivatives : std::false_type {};
+
+template <typename PixelShader>
+struct UsesDerivatives<PixelShader, std::void_t<decltype(PixelShader::UsesDerivatives)>> :
+    std::bool_constant<PixelShader::UsesDerivatives> {};
+
+// a pixel shader whose color depends only on attributes that are the same across the whole
+// triangle (e.g. a face normal) can declare a FlatAttributes member that is true - in which
+// case it is called once per triangle, rather than once per pixel, and nothing is interpolated
+// across the triangle other than its edges
+template <typename PixelShader, typename = void>
+struct UsesFlatAttributes : std::false_type {};
+
+template <typename PixelShader>
+struct UsesFlatAttributes<PixelShader, std::void_t<decltype(PixelShader::FlatAttributes)>> :
+    std::bool_constant<PixelShader::FlatAttributes> {};
+
+// a pixel shader that is happy with attributes interpolated linearly in screen space can declare
+// a PerspectiveCorrect member that is false - in which case attributes are never divided by z
+// (when transformed into screen space) or recovered again (per pixel)
+template <typename PixelShader, typename = void>
+struct NeedsPerspectiveCorrection : std::true_type {};
+
+template <typename PixelShader>
+struct NeedsPerspectiveCorrection<PixelShader, std::void_t<decltype(PixelShader::PerspectiveCorrect)>> :
+    std::bool_constant<PixelShader::PerspectiveCorrect> {};
+
+// a pixel shader can shade a whole row of pixels in one call instead (e.g. with SIMD), by
+// declaring a Span type - the structure-of-arrays form (e.g. an InterpolantSpan) the recovered
+// attributes of the row are gathered into - in which case it is called as
+// pixelShader(attributes, first, pOut, n), or pixelShader(attributes, first, stretches, pOut, n)
+// if it also uses derivatives, and writes n colors to pOut
+// (first is the row's first pixel, for its flat attributes - stretches cover the row, with the
+// derivatives at either end of each (see SpanStretch) - and the attributes may be overwritten,
+// e.g. clamped in place)
+struct NoSpan {};
+
+template <typename PixelShader, typename = void>
+struct UsesSpans : std::false_type
+{
+    typedef NoSpan Span;
+};
+
+template <typename PixelShader>
+struct UsesSpans<PixelShader, std::void_t<typename PixelShader::Span>> : std::true_type
+{
+    typedef typename PixelShader::Span Span;
+};
+
+// a pixel shader whose color is simply three of its attributes - red, green and blue, where 255
+// is full intensity (e.g. an interpolated vertex color) - can declare a ColorAttribute member
+// giving the index of the first of them, in which case rows are stepped across in fixed point
+// (see ColorOps::Ramp) wherever attributes are linear, rather than calling the pixel shader
+template <typename PixelShader, typename = void>
+struct HasColorAttributes : std::false_type {};
+
+template <typename PixelShader>
+struct HasColorAttributes<PixelShader, std::void_t<decltype(PixelShader::ColorAttribute)>> : std::true_type {};
+
+// a geometry shader that just passes triangles through unchanged (so its output vertex type is
+// the vertex shader's) can declare a PassThrough member that is true - in which case it isn't
+// called at all
+template <typename GeometryShader, typename = void>
+struct IsPassThrough : std::false_type {};
+
+template <typename GeometryShader>
+struct IsPassThrough<GeometryShader, std::void_t<decltype(GeometryShader::PassThrough)>> :
+    std::bool_constant<GeometryShader::PassThrough> {};
+
+// a vertex shader can transform a whole mesh at once instead (e.g. with VertexTransform), by
+// declaring a UsesBatches member that is true - in which case it is called as
+// vertexShader(numVertices, positions, normals, outVertices), with the positions (and normals, if
+// the vertices have a norm member) gathered into structure-of-arrays streams (see MeshStreams)
+template <typename VertexShader, typename = void>
+struct UsesBatches : std::false_type {};
+
+template <typename VertexShader>
+struct UsesBatches<VertexShader, std::void_t<decltype(VertexShader::UsesBatches)>> :
+    std::bool_constant<VertexShader::UsesBatches> {};
+
+template <typename Vertex, typename = void>
+struct HasNormals : std::false_type {};
+
+template <typename Vertex>
+struct HasNormals<Vertex, std::void_t<decltype(std::declval<Vertex>().norm)>> : std::true_type {};
+
+#endif /* EffectTraits_hpp */
@@ -11,6 +11,9 @@
 
 #include "Vec3.hpp"
 #include "Color.hpp"
+#include "Vec3Stream.hpp"
+#include "VertexTransform.hpp"
+#include "Interpolants.hpp"
 
 // entire triangles are lit according to their plane normals
 class FlatShadingEffect
@@ -79,11 +82,22 @@ public:
     {
     public:
         typedef Vertex OutVertex;
+        static constexpr bool UsesBatches = true;
         
         OutVertex operator()(const Vertex& vertex)
         {
             return OutVertex(vertex.v * rotMat + transVec);
         };
+        // (the same as above, for a whole mesh at once)
+        // (the vertices have no normals, so that stream is empty)
+        void operator()(size_t numVertices, const Vec3Stream& positions, const Vec3Stream&,
+                        std::vector<OutVertex>& outVertices)
+        {
+            VertexTransform::Transform(positions, rotMat, transVec, transformed);
+            outVertices.resize(numVertices);
+            for (size_t i = 0; i < numVertices; i++)
+                outVertices[i] = OutVertex(transformed.Get(i));
+        }
         void BindRotation(const Mat3& rotMat)
         {
             this->rotMat = rotMat;
@@ -96,6 +110,7 @@ public:
     private:
         Mat3 rotMat;
         Vec3 transVec;
+        Vec3Stream transformed;
     };
  
     // for each triangle, calculate the normal for the plane and add it on each vertex
@@ -104,79 +119,27 @@ public:
     class GeometryShader
     {
     public:
-        class OutVertex
-        {
-        public:
-            OutVertex() = default;
-            OutVertex(const Vec3& v, const Vec3& norm):
-                v(v),
-                norm(norm)
-            {
-            }
-            OutVertex& operator=(const OutVertex& rhs)
-            {
-                v = rhs.v;
-                norm = rhs.norm;
-                return *this;
-            }
-            OutVertex operator+(const OutVertex& rhs) const
-            {
-                return OutVertex(v + rhs.v, norm);
-            }
-            OutVertex& operator+=(const OutVertex& rhs)
-            {
-                *this = *this + rhs;
-                return *this;
-            }
-            OutVertex operator-(const OutVertex& rhs) const
-            {
-                return OutVertex(v - rhs.v, norm);
-            }
-            OutVertex& operator-=(const OutVertex& rhs)
-            {
-                *this = *this - rhs;
-                return *this;
-            }
-            OutVertex operator*(float rhs) const
-            {
-                return OutVertex(v * rhs, norm);
-            }
-            OutVertex& operator*=(float rhs)
-            {
-                *this = *this * rhs;
-                return *this;
-            }
-            OutVertex operator/(float rhs) const
-            {
-                return OutVertex(v / rhs, norm);
-            }
-            OutVertex& operator/=(float rhs)
-            {
-                *this = *this / rhs;
-                return *this;
-            }
-            OutVertex InterpTo(const OutVertex& rhs, float percent) const
-            {
-                return { v.InterpTo(rhs.v, percent), norm };
-            }
-            
-            Vec3 v;
-            Vec3 norm;
-        };
+        // (nothing is interpolated - the normal is a flat attribute)
+        typedef InterpolatedVertex<0, Vec3> OutVertex;
         
         Triangle<GeometryShader::OutVertex> operator()(const Triangle<VertexShader::OutVertex>& t)
         {
             // calculate a single normal for the entire triangle and attach it to all 3 vertices
             Vec3 norm = (t.v2.v - t.v1.v).cross(t.v3.v - t.v1.v).Norm();
-            return Triangle<GeometryShader::OutVertex>({{t.v1.v, norm},
-                {t.v2.v, norm},
-                {t.v3.v, norm}});
+            return Triangle<GeometryShader::OutVertex>({{t.v1.v, {}, norm},
+                {t.v2.v, {}, norm},
+                {t.v3.v, {}, norm}});
         }
     };
 
+    // (the color only depends on the triangle's normal, so it's worked out once per triangle, and
+    // nothing needs perspective correction)
     class PixelShader
     {
     public:
+        static constexpr bool FlatAttributes = true;
+        static constexpr bool PerspectiveCorrect = false;
+        
         PixelShader():
             lightDir(Vec3(1.0f, -1.0f, 2.0f).Norm()),
             ambientLight(0.2f),
@@ -185,8 +148,8 @@ public:
         Color operator()(const GeometryShader::OutVertex& gsOutVertex)
         {
             // shade according to lighting
-            float intensity = std::max(-(gsOutVertex.norm * lightDir), ambientLight);
-            return (c * intensity);
+            float intensity = std::max(-(gsOutVertex.flat * lightDir), ambientLight);
+            return c.Scaled(Color::ToFixed(intensity));
         };
         
     private:
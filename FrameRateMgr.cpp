@@ -10,16 +10,16 @@
 #include "FrameRateMgr.hpp"
 
 FrameRateMgr::FrameRateMgr():
-    lastClockTicks(clock())
+    lastMarkTime(std::chrono::steady_clock::now())
 {
 }
 
 void FrameRateMgr::Mark()
 {
-    clock_t nowClockTicks = clock();
+    auto nowTime = std::chrono::steady_clock::now();
     
-    frameTimeSecs = static_cast<float>(nowClockTicks - lastClockTicks) / CLOCKS_PER_SEC;
-    lastClockTicks = nowClockTicks;
+    frameTimeSecs = std::chrono::duration<float>(nowTime - lastMarkTime).count();
+    lastMarkTime = nowTime;
     
     // print the frame rate
     secsUntilPrint -= frameTimeSecs;
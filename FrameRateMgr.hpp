@@ -9,7 +9,7 @@
 #ifndef FrameRateMgr_hpp
 #define FrameRateMgr_hpp
 
-#include <ctime>
+#include <chrono>
 
 class FrameRateMgr
 {
@@ -24,7 +24,9 @@ public:
 private:
     // time it took to render the last frame, in secs
     float frameTimeSecs = 0.100f; // (something reasonable before the first frame is rendered)
-    clock_t lastClockTicks;
+    // (wall clock time rather than processor time, which does not reflect how long
+    // frames actually take to be shown)
+    std::chrono::steady_clock::time_point lastMarkTime;
     float secsUntilPrint = PrintEverySecs;
 };
 
@@ -0,0 +1,89 @@
+//
+//  Frustum.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <cmath>
+#include "Frustum.hpp"
+#include "Simd.hpp"
+
+Frustum::Frustum(float nearZ, float farZ)
+{
+    // (the side planes are 45 degrees to the z axis - e.g. x >= -z on the left)
+    const float s = 1.0f / sqrtf(2.0f);
+    nx = { s, -s, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    ny = { 0.0f, 0.0f, s, -s, 0.0f, 0.0f, 0.0f, 0.0f };
+    nz = { s, s, s, s, 1.0f, -1.0f, 0.0f, 0.0f };
+    d = { 0.0f, 0.0f, 0.0f, 0.0f, -nearZ, farZ, std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+}
+
+Frustum::Result Frustum::Classify(const BoundingBox& box) const
+{
+    return Classify(box.Center(), box.Extents(), 0.0f);
+}
+
+Frustum::Result Frustum::Classify(const BoundingSphere& sphere) const
+{
+    return Classify(sphere.center, Vec3(0.0f, 0.0f, 0.0f), sphere.radius);
+}
+
+// for each plane, the bounds reach towards it by the radius plus the extents along its normal -
+// they're outside if even that doesn't reach it, and inside if they're on its inner side even
+// when reaching away from it
+Frustum::Result Frustum::Classify(const Vec3& center, const Vec3& extents, float radius) const
+{
+#if SIMD_AVX2
+    const __m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(nx.data()), _mm256_set1_ps(center.x)),
+                                                    _mm256_mul_ps(_mm256_loadu_ps(ny.data()), _mm256_set1_ps(center.y))),
+                                      _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(nz.data()), _mm256_set1_ps(center.z)),
+                                                    _mm256_loadu_ps(d.data())));
+    // (the absolute values of the normals, by clearing their sign bits)
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 reach = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_and_ps(_mm256_loadu_ps(nx.data()), absMask), _mm256_set1_ps(extents.x)),
+                                                     _mm256_mul_ps(_mm256_and_ps(_mm256_loadu_ps(ny.data()), absMask), _mm256_set1_ps(extents.y))),
+                                       _mm256_add_ps(_mm256_mul_ps(_mm256_and_ps(_mm256_loadu_ps(nz.data()), absMask), _mm256_set1_ps(extents.z)),
+                                                     _mm256_set1_ps(radius)));
+    if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(dist, reach), _mm256_setzero_ps(), _CMP_LT_OQ)))
+        return Result::Outside;
+    if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_sub_ps(dist, reach), _mm256_setzero_ps(), _CMP_LT_OQ)))
+        return Result::Intersecting;
+    return Result::Inside;
+#elif SIMD_SSE2
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    int outside = 0;
+    int crossing = 0;
+    for (int i = 0; i < NumLanes; i += 4)
+    {
+        const __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&nx[i]), _mm_set1_ps(center.x)),
+                                                  _mm_mul_ps(_mm_loadu_ps(&ny[i]), _mm_set1_ps(center.y))),
+                                       _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&nz[i]), _mm_set1_ps(center.z)),
+                                                  _mm_loadu_ps(&d[i])));
+        const __m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(_mm_loadu_ps(&nx[i]), absMask), _mm_set1_ps(extents.x)),
+                                                   _mm_mul_ps(_mm_and_ps(_mm_loadu_ps(&ny[i]), absMask), _mm_set1_ps(extents.y))),
+                                        _mm_add_ps(_mm_mul_ps(_mm_and_ps(_mm_loadu_ps(&nz[i]), absMask), _mm_set1_ps(extents.z)),
+                                                   _mm_set1_ps(radius)));
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, reach), _mm_setzero_ps()));
+        crossing |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(dist, reach), _mm_setzero_ps()));
+    }
+    if (outside)
+        return Result::Outside;
+    if (crossing)
+        return Result::Intersecting;
+    return Result::Inside;
+#else
+    Result res = Result::Inside;
+    for (int i = 0; i < NumPlanes; i++)
+    {
+        float dist = (nx[i] * center.x + ny[i] * center.y) + (nz[i] * center.z + d[i]);
+        float reach = (fabsf(nx[i]) * extents.x + fabsf(ny[i]) * extents.y) + (fabsf(nz[i]) * extents.z + radius);
+        if (dist + reach < 0.0f)
+            return Result::Outside;
+        if (dist - reach < 0.0f)
+            res = Result::Intersecting;
+    }
+    return res;
+#endif
+}
@@ -0,0 +1,58 @@
+//
+//  Frustum.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef Frustum_hpp
+#define Frustum_hpp
+
+#include <array>
+#include <limits>
+#include "Vec3.hpp"
+#include "BoundingBox.hpp"
+#include "BoundingSphere.hpp"
+
+// the part of camera space that ends up on screen - the view is the same as Pipeline's (camera
+// at the origin looking down +z, with x/z and y/z from -1 to +1 across the screen), between a
+// near and a far distance
+// bounds are tested against all of its planes at once (8 with AVX2, 4 at a time with SSE2), so
+// that whole groups of objects (see Bvh) can be thrown out before any of their vertices are
+// shaded
+class Frustum
+{
+public:
+    enum class Result
+    {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+    static constexpr float DefaultNearZ = 0.01f;
+
+    Frustum(float nearZ = DefaultNearZ, float farZ = std::numeric_limits<float>::max());
+    // (bounds in camera space - see BoundingBox::Transformed())
+    Result Classify(const BoundingBox& box) const;
+    Result Classify(const BoundingSphere& sphere) const;
+    ~Frustum() = default;
+
+private:
+    // (a box's extents and a sphere's radius are both how far the bounds reach past their center
+    // towards a plane, so both are tested the same way, with whichever doesn't apply as zero)
+    Result Classify(const Vec3& center, const Vec3& extents, float radius) const;
+
+    // left, right, bottom, top, near and far - stored across the lanes of a vector, one plane per
+    // lane, with unit normals pointing inwards (so a point p is inside a plane if n * p + d >= 0)
+    // (the unused lanes have planes that everything is inside)
+    static constexpr int NumPlanes = 6;
+    static constexpr int NumLanes = 8;
+    std::array<float, NumLanes> nx;
+    std::array<float, NumLanes> ny;
+    std::array<float, NumLanes> nz;
+    std::array<float, NumLanes> d;
+};
+
+#endif /* Frustum_hpp */
@@ -6,23 +6,21 @@
 //  Copyright © 2020 Brian Dolan. All rights reserved.
 //
 
+#include <algorithm>
 #include "Game.hpp"
 #include "IndexedTriangleList.hpp"
 #include "TextureEffect.hpp"
 #include "Utils.hpp"
+#include "TextureResidency.hpp"
+#include "TextureManager.hpp"
 
 Game::Game():
-    pT(g),
-    pVC(g),
-    pFS(g),
-    pG(g)
+    c(pool.Submit([]() { return Cube(); })),
+    sFS(pool.Submit([]() { return Sphere::GetLodFS(); })),
+    sG(pool.Submit([]() { return Sphere::GetLodG(); })),
+    brickTexture(pool.Submit([]() { return TextureManager::Get().Load("brick.bmp", CompressTextures); })),
+    field(pool.Submit([]() { return CubeField(); }))
 {
-    // push objects away from the camera as clipping is not currently handled
-    Vec3 transVec(0.0f, 0.0f, 2.0f);
-    pT.effect.vertexShader.BindTranslation(transVec);
-    pVC.effect.vertexShader.BindTranslation(transVec);
-    pFS.effect.vertexShader.BindTranslation(transVec);
-    pG.effect.vertexShader.BindTranslation(transVec);
 }
 
 bool Game::ProcessFrame()
@@ -36,8 +34,14 @@ bool Game::ProcessFrame()
         g.BeginFrame();
         ComposeFrame();
         g.EndFrame();
+        
+        // (between frames, while nothing is sampling textures)
+        TextureResidency::Get().Update();
 
         frm.Mark();
+        
+        // lower or raise the render resolution to hold the target frame rate
+        g.SetRenderScale(rs.Update(frm.GetFrameTimeSecs()));
     }
     
     return quit;
@@ -50,32 +54,66 @@ void Game::ComposeFrame()
     // textured, flat-shaded cube
     case 0:
     {
-        IndexedTriangleList<TextureEffect::Vertex> itlct = c.GetIndexedTriangleListTex();
-        pT.Draw(itlct);
+        if (!c.IsReady() || !brickTexture.IsReady())
+        {
+            ComposeLoadingFrame();
+            break;
+        }
+        if (!IsOnScreen(c.Get().GetBoundingBox()))
+            break;
+        IndexedTriangleList<TextureEffect::Vertex> itlct = c.Get().GetIndexedTriangleListTex();
+        Draw(pT, itlct, brickTexture.Get());
         break;
     }
             
     // vertex-colored cube
     case 1:
     {
-        IndexedTriangleList<VertexColorEffect::Vertex> itlcvc = c.GetIndexedTriangleListVC();
-        pVC.Draw(itlcvc);
+        if (!c.IsReady())
+        {
+            ComposeLoadingFrame();
+            break;
+        }
+        if (!IsOnScreen(c.Get().GetBoundingBox()))
+            break;
+        IndexedTriangleList<VertexColorEffect::Vertex> itlcvc = c.Get().GetIndexedTriangleListVC();
+        Draw(pVC, itlcvc);
         break;
     }
             
     // flat-shaded sphere
     case 2:
     {
-        IndexedTriangleList<FlatShadingEffect::Vertex> itlsfs = s.GetIndexedTriangleListFS();
-        pFS.Draw(itlsfs);
+        if (!sFS.IsReady())
+        {
+            ComposeLoadingFrame();
+            break;
+        }
+        Draw(pFS, sFS.Get(), sphereLevel);
         break;
     }
 
     // gouraud-shaded sphere
     case 3:
     {
-        IndexedTriangleList<GouraudEffect::Vertex> itlsg = s.GetIndexedTriangleListG();
-        pG.Draw(itlsg);
+        if (!sG.IsReady())
+        {
+            ComposeLoadingFrame();
+            break;
+        }
+        Draw(pG, sG.Get(), sphereLevel);
+        break;
+    }
+    
+    // field of cubes, mostly hidden
+    case 4:
+    {
+        if (!field.IsReady())
+        {
+            ComposeLoadingFrame();
+            break;
+        }
+        DrawField(field.Get());
         break;
     }
             
@@ -84,12 +122,71 @@ void Game::ComposeFrame()
     }
 }
 
+// draws a bar across the middle of the screen, filled in according to how many assets have loaded
+void Game::ComposeLoadingFrame()
+{
+    int numReady = (c.IsReady() ? 1 : 0) + (sFS.IsReady() ? 1 : 0) + (sG.IsReady() ? 1 : 0) + (brickTexture.IsReady() ? 1 : 0) +
+        (field.IsReady() ? 1 : 0);
+    
+    int barWidth = g.GetScreenWidth() / 2;
+    int barHeight = std::max(g.GetScreenHeight() / 40, 1);
+    int xStart = (g.GetScreenWidth() - barWidth) / 2;
+    int yStart = (g.GetScreenHeight() - barHeight) / 2;
+    int filledWidth = barWidth * numReady / NumAssets;
+    
+    for (int y = yStart; y < yStart + barHeight; y++)
+        for (int x = xStart; x < xStart + barWidth; x++)
+            g.PutPixel(x, y, (x - xStart < filledWidth) ? Colors::White : Colors::Gray);
+}
+
+// the walls are drawn into the occlusion buffer first - then the objects are drawn (from the
+// furthest to the nearest) only if they're on screen, and not hidden behind the walls
+// (the objects on screen are found with a BVH, so that whole groups of them off screen are
+// thrown out at once)
+void Game::DrawField(const CubeField& f)
+{
+    const Vec3 center(0.0f, 0.0f, FieldDistance);
+    occlusion.Clear();
+    occlusion.AddOccluder(f.GetOccluderStreams(), f.GetOccluders().triangles, rotMat, center);
+    
+    // (each object is moved out to its place in the field, which is rotated along with it)
+    const std::vector<CubeField::Object>& objects = f.GetObjects();
+    fieldBounds.resize(objects.size());
+    for (size_t i = 0; i < objects.size(); i++)
+        fieldBounds[i] = f.GetBoundingBox(objects[i].kind).Transformed(rotMat, objects[i].position * rotMat + center);
+    if (fieldBvh.IsEmpty())
+        fieldBvh.Build(fieldBounds);
+    else
+        fieldBvh.Refit(fieldBounds);
+    fieldBvh.FindVisible(frustum, onScreenObjects);
+    
+    visibleObjects.clear();
+    for (size_t i : onScreenObjects)
+    {
+        const CubeField::Object& o = objects[i];
+        Vec3 transVec = o.position * rotMat + center;
+        if (!occlusion.IsVisible(f.GetBoundingBox(o.kind), rotMat, transVec))
+            continue;
+        visibleObjects.push_back({ transVec.MagSq(), &o });
+    }
+    std::sort(visibleObjects.begin(), visibleObjects.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+    
+    Pipeline<FlatShadingEffect>& p = PreparePipeline(pField);
+    for (const auto& v : visibleObjects)
+    {
+        const CubeField::Object& o = *v.second;
+        p.effect.vertexShader.BindTranslation(o.position * rotMat + center);
+        p.Draw(f.GetMesh(o.kind), f.GetStreams(o.kind));
+    }
+}
+
 void Game::HandleInput()
 {
     // handle scene switching
     
     if (i.GetTabFirstPressed())
-        if (++sceneNum > 3)
+        if (++sceneNum > 4)
             sceneNum = 0;
     
     // handle rotation, with speed based on frame rate
@@ -108,9 +205,5 @@ void Game::HandleInput()
         Utils::NormalizeAngle(rotXAngle);
     }
     
-    Mat3 rotMat = Mat3::RotY(rotYAngle) * Mat3::RotX(rotXAngle);
-    pT.effect.vertexShader.BindRotation(rotMat);
-    pVC.effect.vertexShader.BindRotation(rotMat);
-    pFS.effect.vertexShader.BindRotation(rotMat);
-    pG.effect.vertexShader.BindRotation(rotMat);
+    rotMat = Mat3::RotY(rotYAngle) * Mat3::RotX(rotXAngle);
 }
\ No newline at end of file
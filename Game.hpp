@@ -9,15 +9,27 @@
 #ifndef Game_hpp
 #define Game_hpp
 
+#include <memory>
+#include <vector>
+#include <utility>
 #include "Graphics.hpp"
 #include "Input.hpp"
 #include "Cube.hpp"
 #include "Sphere.hpp"
+#include "MeshLod.hpp"
+#include "CubeField.hpp"
+#include "BoundingBox.hpp"
+#include "Frustum.hpp"
+#include "Bvh.hpp"
+#include "OcclusionBuffer.hpp"
 #include "Pipeline.hpp"
 #include "TextureEffect.hpp"
 #include "VertexColorEffect.hpp"
 #include "FlatShadingEffect.hpp"
 #include "FrameRateMgr.hpp"
+#include "ResolutionScaler.hpp"
+#include "ThreadPool.hpp"
+#include "Asset.hpp"
 
 class Game
 {
@@ -28,24 +40,97 @@ public:
     
 private:
     void ComposeFrame();
+    void ComposeLoadingFrame();
     void HandleInput();
+    void DrawField(const CubeField& f);
+    // a scene's pipeline, which is only created the first time it is needed, ready to draw with
+    template <typename Effect, typename... EffectArgs>
+    Pipeline<Effect>& PreparePipeline(std::unique_ptr<Pipeline<Effect>>& pPipeline, EffectArgs&&... effectArgs)
+    {
+        if (!pPipeline)
+        {
+            pPipeline = std::make_unique<Pipeline<Effect>>(g, std::forward<EffectArgs>(effectArgs)...);
+            
+            // push objects away from the camera as clipping is not currently handled
+            pPipeline->effect.vertexShader.BindTranslation(Vec3(0.0f, 0.0f, ObjectDistance));
+            pPipeline->SetPerspectiveSpan(PerspectiveSpan);
+        }
+        
+        pPipeline->effect.vertexShader.BindRotation(rotMat);
+        return *pPipeline;
+    }
+    template <typename Effect, typename... EffectArgs>
+    void Draw(std::unique_ptr<Pipeline<Effect>>& pPipeline, const IndexedTriangleList<typename Effect::Vertex>& itl,
+              EffectArgs&&... effectArgs)
+    {
+        PreparePipeline(pPipeline, std::forward<EffectArgs>(effectArgs)...).Draw(itl);
+    }
+    // (the same, picking the level of detail to draw at from how big the mesh is on screen)
+    template <typename Effect>
+    void Draw(std::unique_ptr<Pipeline<Effect>>& pPipeline, const MeshLod<typename Effect::Vertex>& lod, int& level)
+    {
+        if (!IsOnScreen(lod.GetBoundingBox()))
+            return;
+        level = lod.SelectLevel(lod.ScreenSize(ObjectDistance, g.GetScreenWidth()), level);
+        PreparePipeline(pPipeline).Draw(lod.GetLevel(level), lod.GetStreams(level));
+    }
+    // (false if an object with the given model space bounds would be drawn entirely off screen,
+    // in which case there's no need to draw it at all)
+    bool IsOnScreen(const BoundingBox& box) const
+    {
+        return frustum.Classify(box.Transformed(rotMat, Vec3(0.0f, 0.0f, ObjectDistance))) != Frustum::Result::Outside;
+    }
     
-    Cube c;
-    Sphere s;
-
     Graphics g;
     
-    Pipeline<TextureEffect> pT;
-    Pipeline<VertexColorEffect> pVC;
-    Pipeline<FlatShadingEffect> pFS;
-    Pipeline<GouraudEffect> pG;
+    // assets are loaded in the background, so that frames can be shown in the meantime - a
+    // scene is drawn as soon as the assets it needs are ready
+    ThreadPool pool;
+    Asset<Cube> c;
+    Asset<MeshLod<FlatShadingEffect::Vertex>> sFS;
+    Asset<MeshLod<GouraudEffect::Vertex>> sG;
+    Asset<std::shared_ptr<const Texture>> brickTexture;
+    Asset<CubeField> field;
+    static constexpr int NumAssets = 5;
+    
+    // (see Pipeline::SetPerspectiveSpan())
+    static constexpr int PerspectiveSpan = 8;
+    // (see Texture::Compress() - textures look a little blockier, but take an 8th of the memory)
+    static constexpr bool CompressTextures = true;
+    
+    // (how far in front of the camera objects are drawn)
+    static constexpr float ObjectDistance = 2.0f;
+    // (the same for the center of the field, which is far enough away that none of it is ever
+    // behind the camera)
+    static constexpr float FieldDistance = CubeField::Radius + 1.0f;
+    
+    Frustum frustum;
+    OcclusionBuffer occlusion;
+    // (over the field's objects, in camera space - built the first time the field is drawn, and
+    // refit to wherever they've been rotated to after that)
+    Bvh fieldBvh;
+    // (the rest are kept between frames, so that their memory is reused - the field's objects'
+    // bounds in camera space, the ones on screen, and the ones to be drawn, furthest first)
+    std::vector<BoundingBox> fieldBounds;
+    std::vector<size_t> onScreenObjects;
+    std::vector<std::pair<float, const CubeField::Object*>> visibleObjects;
+    
+    std::unique_ptr<Pipeline<TextureEffect>> pT;
+    std::unique_ptr<Pipeline<VertexColorEffect>> pVC;
+    std::unique_ptr<Pipeline<FlatShadingEffect>> pFS;
+    std::unique_ptr<Pipeline<GouraudEffect>> pG;
+    std::unique_ptr<Pipeline<FlatShadingEffect>> pField;
     
     Input i;
     FrameRateMgr frm;
+    ResolutionScaler rs;
 
     int sceneNum = 0;    
+    // (the level of detail the sphere was last drawn at - see MeshLod)
+    int sphereLevel = 0;
     float rotYAngle = 0.0f;
     float rotXAngle = 0.0f;
+    Mat3 rotMat = Mat3::Identity();
 };
 
 #endif /* Game_hpp */
@@ -12,7 +12,11 @@
 #include "Vec3.hpp"
 #include "Color.hpp"
 #include "Mat3.hpp"
+#include "Vec3Stream.hpp"
+#include "VertexTransform.hpp"
 #include "Triangle.hpp"
+#include "Interpolants.hpp"
+#include "ColorPixelShader.hpp"
 
 // vertices are lit according to mesh-defined normals, and colors are interpolated between them
 // screen-linearly
@@ -79,72 +83,17 @@ public:
         Vec3 norm;
     };
     
+    // the attributes interpolated across triangles (see Interpolants)
+    enum Attribute { R, G, B, NumAttributes };
+    
     // handles rotation/translation
     // outputs color at each vertex, as per normals/lighting
     class VertexShader
     {
     public:
         // position and color, with interpolation for both
-        class OutVertex
-        {
-        public:
-            OutVertex() = default;
-            OutVertex(const Vec3& v, const Vec3& c):
-                v(v),
-                c(c)
-            {
-            }
-            OutVertex& operator=(const OutVertex& rhs)
-            {
-                v = rhs.v;
-                c = rhs.c;
-                return *this;
-            }
-            OutVertex operator+(const OutVertex& rhs) const
-            {
-                return OutVertex(v + rhs.v, c + rhs.c);
-            }
-            OutVertex& operator+=(const OutVertex& rhs)
-            {
-                *this = *this + rhs;
-                return *this;
-            }
-            OutVertex operator-(const OutVertex& rhs) const
-            {
-                return OutVertex(v - rhs.v, c - rhs.c);
-            }
-            OutVertex& operator-=(const OutVertex& rhs)
-            {
-                *this = *this - rhs;
-                return *this;
-            }
-            OutVertex operator*(float rhs) const
-            {
-                return OutVertex(v * rhs, c * rhs);
-            }
-            OutVertex& operator*=(float rhs)
-            {
-                *this = *this * rhs;
-                return *this;
-            }
-            OutVertex operator/(float rhs) const
-            {
-                return OutVertex(v / rhs, c / rhs);
-            }
-            OutVertex& operator/=(float rhs)
-            {
-                *this = *this / rhs;
-                return *this;
-            }
-            OutVertex InterpTo(const OutVertex& rhs, float percent) const
-            {
-                return { v.InterpTo(rhs.v, percent),
-                    c.InterpTo(rhs.c, percent) };
-            }
-            
-            Vec3 v;
-            Vec3 c; // color
-        };
+        typedef InterpolatedVertex<NumAttributes> OutVertex;
+        static constexpr bool UsesBatches = true;
         
         VertexShader():
             lightDir(Vec3(1.0f, -1.0f, 2.0f).Norm()),
@@ -160,8 +109,26 @@ public:
             float intensity = std::max(-(rotNorm * lightDir), ambientLight);
             
             // rotate and translate the position vector
-            return OutVertex(vertex.v * rotMat + transVec, vc * intensity);
+            Vec3 c = vc * intensity;
+            return OutVertex(vertex.v * rotMat + transVec, { c.x, c.y, c.z });
         };
+        // (the same as above, for a whole mesh at once)
+        void operator()(size_t numVertices, const Vec3Stream& positions, const Vec3Stream& normals,
+                        std::vector<OutVertex>& outVertices)
+        {
+            VertexTransform::Transform(positions, rotMat, transVec, transformed);
+            VertexTransform::Rotate(normals, rotMat, rotNorms);
+            outVertices.resize(numVertices);
+            for (size_t i = 0; i < numVertices; i++)
+            {
+                float intensity = std::max(-(rotNorms.x[i] * lightDir.x + rotNorms.y[i] * lightDir.y + rotNorms.z[i] * lightDir.z), ambientLight);
+                OutVertex& out = outVertices[i];
+                out.v = transformed.Get(i);
+                out.attr[R] = vc.x * intensity;
+                out.attr[G] = vc.y * intensity;
+                out.attr[B] = vc.z * intensity;
+            }
+        }
         void BindRotation(const Mat3& rotMat)
         {
             this->rotMat = rotMat;
@@ -177,6 +144,8 @@ public:
         Vec3 vc; // color
         Mat3 rotMat;
         Vec3 transVec;
+        Vec3Stream transformed;
+        Vec3Stream rotNorms;
     };
     
     // a dumb "pass-through" geometry shader - the input and output types are the same type
@@ -184,6 +153,7 @@ public:
     {
     public:
         typedef VertexShader::OutVertex OutVertex;
+        static constexpr bool PassThrough = true;
         
         Triangle<GeometryShader::OutVertex> operator()(const Triangle<VertexShader::OutVertex>& t)
         {
@@ -191,17 +161,8 @@ public:
         }
     };
 
-    class PixelShader
-    {
-    public:
-        Color operator()(const GeometryShader::OutVertex& gsOutVertex)
-        {
-            // simply return the color, which was linearly interpolated between vertices
-            return gsOutVertex.c;
-        };
-        
-    private:
-    };
+    // (the colors lit at the vertices, interpolated - see ColorPixelShader)
+    typedef ColorPixelShader<NumAttributes, R> PixelShader;
     
     VertexShader vertexShader;
     GeometryShader geometryShader;
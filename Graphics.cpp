@@ -8,6 +8,7 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <type_traits>
 #include "Graphics.hpp"
 #include "Utils.hpp"
 
@@ -23,21 +24,28 @@ std::string Graphics::SDLException::GetMsg() const
 }
 
 Graphics::Graphics() :
-    screen(ScreenWidth, ScreenHeight)
+    screen(WindowWidth, WindowHeight)
 {
     if (SDL_Init(SDL_INIT_VIDEO) < 0)
         throw SDLException("Error initializating SDL");
     
     Uint32 windowFlags = SDL_WINDOW_SHOWN;
-    SDL_CreateWindowAndRenderer(ScreenWidth, ScreenHeight, windowFlags, &pWindow, &pRenderer);
+    SDL_CreateWindowAndRenderer(WindowWidth, WindowHeight, windowFlags, &pWindow, &pRenderer);
     if (pWindow == NULL)
         throw SDLException("Window could not be created");
 
-    pScreenTexture = SDL_CreateTexture(pRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, ScreenWidth, ScreenHeight);
+    // the screen texture is always created at the full window size - when rendering at a lower
+    // resolution, only the upper left portion of it is updated and then stretched over the window
+    // (with linear filtering to soften the upscale)
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+    Uint32 screenTextureFormat = std::is_same<ScreenFormat, PixelFormats::RGB565>::value ? SDL_PIXELFORMAT_RGB565 : SDL_PIXELFORMAT_ARGB8888;
+    pScreenTexture = SDL_CreateTexture(pRenderer, screenTextureFormat, SDL_TEXTUREACCESS_STATIC, WindowWidth, WindowHeight);
     if (pScreenTexture == NULL)
         throw SDLException("Could not create screen texture");
     
     SDL_RaiseWindow(pWindow);
+    
+    ResetTiles();
 }
 
 Graphics::~Graphics()
@@ -50,40 +58,125 @@ Graphics::~Graphics()
 
 void Graphics::BeginFrame()
 {
-    memset(screen.GetPixelBuffer(), 0, ScreenWidth * ScreenHeight * sizeof(uint32_t)/sizeof(uint8_t));
+    // only change resolution between frames, so that a frame is never rendered at a mix of sizes
+    if (pendingRenderScale != renderScale)
+    {
+        int w = std::max(1, static_cast<int>(static_cast<float>(WindowWidth) * pendingRenderScale + 0.5f));
+        int h = std::max(1, static_cast<int>(static_cast<float>(WindowHeight) * pendingRenderScale + 0.5f));
+        if (w != screen.Width() || h != screen.Height())
+            screen = ScreenSurface(w, h);
+        renderScale = pendingRenderScale;
+    }
+    
+    // (tiles are cleared as they are drawn in)
+    ResetTiles();
+}
+
+void Graphics::ResetTiles()
+{
+    tilesX = (screen.Width() + TileSize - 1) / TileSize;
+    tilesY = (screen.Height() + TileSize - 1) / TileSize;
+    tileCleared.assign(tilesX * tilesY, 0);
+}
+
+void Graphics::ClearTile(int tile)
+{
+    int xStart = (tile % tilesX) * TileSize;
+    int yStart = (tile / tilesX) * TileSize;
+    int xEnd = std::min(xStart + TileSize, screen.Width());
+    int yEnd = std::min(yStart + TileSize, screen.Height());
+    
+    for (int y = yStart; y < yEnd; y++)
+    {
+        ScreenFormat::Pixel* pRow = screen.GetRow(y);
+        std::fill(pRow + xStart, pRow + xEnd, ScreenFormat::FromColor(clearColor));
+    }
+    tileCleared[tile] = 1;
 }
 
 void Graphics::EndFrame()
 {
-    if (SDL_UpdateTexture(pScreenTexture, NULL, screen.GetPixelBuffer(), ScreenWidth * sizeof(unsigned int)) < 0)
-        throw SDLException("Could not update screen texture");
+    // only the block of tiles that were drawn in is presented - any tiles within it that weren't
+    // drawn in are cleared now
+    int tileXStart = tilesX, tileYStart = tilesY, tileXEnd = 0, tileYEnd = 0;
+    for (int tileY = 0; tileY < tilesY; tileY++)
+    {
+        for (int tileX = 0; tileX < tilesX; tileX++)
+        {
+            if (tileCleared[tileY * tilesX + tileX])
+            {
+                tileXStart = std::min(tileXStart, tileX);
+                tileYStart = std::min(tileYStart, tileY);
+                tileXEnd = std::max(tileXEnd, tileX + 1);
+                tileYEnd = std::max(tileYEnd, tileY + 1);
+            }
+        }
+    }
+    for (int tileY = tileYStart; tileY < tileYEnd; tileY++)
+        for (int tileX = tileXStart; tileX < tileXEnd; tileX++)
+            if (!tileCleared[tileY * tilesX + tileX])
+                ClearTile(tileY * tilesX + tileX);
     
-    if (SDL_RenderCopy(pRenderer, pScreenTexture, NULL, NULL) < 0)
-        throw SDLException("Could not render screen copy");
+    if (SDL_SetRenderDrawColor(pRenderer, clearColor.R(), clearColor.G(), clearColor.B(), 0xFF) < 0 ||
+        SDL_RenderClear(pRenderer) < 0)
+        throw SDLException("Could not clear window");
+    
+    if (tileXStart < tileXEnd)
+    {
+        SDL_Rect srcRect;
+        srcRect.x = tileXStart * TileSize;
+        srcRect.y = tileYStart * TileSize;
+        srcRect.w = std::min(tileXEnd * TileSize, screen.Width()) - srcRect.x;
+        srcRect.h = std::min(tileYEnd * TileSize, screen.Height()) - srcRect.y;
+        
+        const ScreenFormat::Pixel* pSrc = screen.GetRow(srcRect.y) + srcRect.x;
+        if (SDL_UpdateTexture(pScreenTexture, &srcRect, pSrc, screen.Pitch() * sizeof(ScreenFormat::Pixel)) < 0)
+            throw SDLException("Could not update screen texture");
+        
+        // stretch the rendered portion of the texture over the matching part of the window
+        SDL_Rect dstRect;
+        dstRect.x = srcRect.x * static_cast<int>(WindowWidth) / screen.Width();
+        dstRect.y = srcRect.y * static_cast<int>(WindowHeight) / screen.Height();
+        dstRect.w = (srcRect.x + srcRect.w) * static_cast<int>(WindowWidth) / screen.Width() - dstRect.x;
+        dstRect.h = (srcRect.y + srcRect.h) * static_cast<int>(WindowHeight) / screen.Height() - dstRect.y;
+        if (SDL_RenderCopy(pRenderer, pScreenTexture, &srcRect, &dstRect) < 0)
+            throw SDLException("Could not render screen copy");
+    }
     
     SDL_RenderPresent(pRenderer);
 }
 
+void Graphics::SetRenderScale(float scale)
+{
+    // takes effect at the beginning of the next frame
+    Utils::Clamp(scale, static_cast<float>(MinRenderScale), 1.0f);
+    pendingRenderScale = scale;
+}
+
 Surface Graphics::LoadTexture(std::string filename)
 {
     SDL_Surface* pSurf = SDL_LoadBMP(filename.c_str());
     if (!pSurf)
         throw SDLException("Could not load texture");
-   
-    Surface s(pSurf->w, pSurf->h);
     
-    // load image into pixels array in ARGB format
-    // (no problem if this is slow)
-    auto pPixelBuffer = s.GetPixelBuffer();
-    int offset = 0;
-    for (int y = 0; y < pSurf->h; y++)
+    // let SDL convert the whole image to ARGB in one pass (whatever format the file was in),
+    // then copy it over row by row - the rows of an SDL surface may be padded
+    SDL_Surface* pConvertedSurf = SDL_ConvertSurfaceFormat(pSurf, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(pSurf);
+    if (!pConvertedSurf)
+        throw SDLException("Could not convert texture");
+    
+    Surface s(pConvertedSurf->w, pConvertedSurf->h);
+    
+    const unsigned char* pSrcRow = static_cast<const unsigned char*>(pConvertedSurf->pixels);
+    for (int y = 0; y < pConvertedSurf->h; y++)
     {
-        for (int x = 0; x < pSurf->w; x++)
-        {
-            pPixelBuffer[offset++] = GetSDLSurfaceColor(*pSurf, x, y);
-        }
+        memcpy(s.GetRow(y), pSrcRow, pConvertedSurf->w * sizeof(unsigned int));
+        pSrcRow += pConvertedSurf->pitch;
     }
     
+    SDL_FreeSurface(pConvertedSurf);
+    
     return s;
 }
 
@@ -92,45 +185,3 @@ void Graphics::PutPixel(int x, int y, int r, int g, int b)
     PutPixel(x, y, Color(r, g, b));
 }
 
-void Graphics::PutPixel(int x, int y, const Color& c)
-{
-    screen.PutPixel(x, y, c);
-}
-
-Color Graphics::GetSDLSurfaceColor(const SDL_Surface& surface, int x, int y)
-{
-    const SDL_PixelFormat* pPixelFormat = surface.format;
-    unsigned char *pPixels = (unsigned char *)surface.pixels;
-    
-    unsigned char* pPixel = &pPixels[((y * surface.w) + x) * pPixelFormat->BytesPerPixel];
-    
-    Uint32 pixel;
-    switch (pPixelFormat->BytesPerPixel)
-    {
-        case 1:
-            pixel = *pPixel;
-            break;
-            
-        case 2:
-            pixel = *(Uint16 *)pPixel;
-            break;
-            
-        case 3:
-            if (SDL_BYTEORDER == SDL_BIG_ENDIAN)
-                pixel = pPixel[0] << 16 | pPixel[1] << 8 | pPixel[2];
-            else
-                pixel = pPixel[0] | pPixel[1] << 8 | pPixel[2] << 16;
-            break;
-            
-        case 4:
-            pixel = *(Uint32 *)pPixel;
-            break;
-            
-        default:
-            pixel = 0;
-    }
-
-    Uint8 r, g, b;
-    SDL_GetRGB(pixel, pPixelFormat, &r, &g, &b);
-    return Color(r, g, b);
-}
\ No newline at end of file
@@ -11,6 +11,7 @@
 
 #include <string>
 #include <cmath>
+#include <vector>
 #include "SDLHeader.hpp"
 #include "Color.hpp"
 #include "Vec2.hpp"
@@ -19,6 +20,17 @@
 class Graphics
 {
 public:
+    // the format of the screen surface - low-end builds can define ENGINE3D_SCREEN_RGB565 for a
+    // 16-bit screen, which halves the memory bandwidth used drawing and presenting frames (the
+    // screen texture is in the same format, and is converted for display as it is presented)
+#if defined(ENGINE3D_SCREEN_RGB565)
+    typedef PixelFormats::RGB565 ScreenFormat;
+#else
+    typedef PixelFormats::ARGB8888 ScreenFormat;
+#endif
+    typedef BasicSurface<ScreenFormat> ScreenSurface;
+    
+
     class Exception
     {
     public:
@@ -30,9 +42,38 @@ public:
     Graphics& operator=(const Graphics&) = delete;
     void BeginFrame();
     void EndFrame();
+    void SetRenderScale(float scale);
+    float GetRenderScale() const { return renderScale; }
+    int GetScreenWidth() const { return screen.Width(); }
+    int GetScreenHeight() const { return screen.Height(); }
+    // (the color of anything not drawn over in a frame)
+    void SetClearColor(const Color& c) { clearColor = c; }
     static Surface LoadTexture(std::string filename);
     void PutPixel(int x, int y, int r, int g, int b);
-    void PutPixel(int x, int y, const Color& c);
+    void PutPixel(int x, int y, const Color& c)
+    {
+        // (x and y are never negative, so shifts can stand in for division)
+        int tile = (y >> TileShift) * tilesX + (x >> TileShift);
+        if (!tileCleared[tile])
+            ClearTile(tile);
+        screen.PutPixel(x, y, c);
+    }
+    // draws the pixels from x0 up to (but not including) x1 on a row in one go
+    void WriteSpan(int y, int x0, int x1, const unsigned int* pColors)
+    {
+        if (x1 <= x0)
+            return;
+        TouchTiles(y, x0, x1);
+        screen.WriteSpan(y, x0, x1, pColors);
+    }
+    // (the same, where every pixel of the span is the same color)
+    void FillSpan(int y, int x0, int x1, const Color& c)
+    {
+        if (x1 <= x0)
+            return;
+        TouchTiles(y, x0, x1);
+        screen.FillSpan(y, x0, x1, c);
+    }
     ~Graphics();
     
 private:
@@ -46,16 +87,42 @@ private:
         std::string msg;
     };
 
-    static Color GetSDLSurfaceColor(const SDL_Surface& surface, int x, int y);
-
+    void ResetTiles();
+    void ClearTile(int tile);
+    // clears whichever of the tiles under a (non-empty) span haven't been yet
+    void TouchTiles(int y, int x0, int x1)
+    {
+        int rowTiles = (y >> TileShift) * tilesX;
+        for (int tile = rowTiles + (x0 >> TileShift); tile <= rowTiles + ((x1 - 1) >> TileShift); tile++)
+            if (!tileCleared[tile])
+                ClearTile(tile);
+    }
+    
     SDL_Window* pWindow;
     SDL_Renderer* pRenderer;
     SDL_Texture* pScreenTexture;
-    Surface screen;
+    ScreenSurface screen;
+    
+    // fraction of the window dimensions that is actually rendered - the screen surface is
+    // upscaled to the full window when presenting
+    float renderScale = 1.0f;
+    float pendingRenderScale = 1.0f;
+    
+    // rather than clearing the whole screen at the start of each frame, the screen is cleared a
+    // tile at a time, when something is first drawn in a tile - tiles nothing is drawn in are
+    // never written to, and are simply left out when presenting, over a clear window
+    static constexpr int TileShift = 5;
+    static constexpr int TileSize = 1 << TileShift;
+    int tilesX;
+    int tilesY;
+    std::vector<unsigned char> tileCleared;
+    Color clearColor = Colors::Black;
     
 public:
-    static constexpr unsigned int ScreenWidth = 640u;
-    static constexpr unsigned int ScreenHeight = 640u;
+    static constexpr unsigned int WindowWidth = 640u;
+    static constexpr unsigned int WindowHeight = 640u;
+    // (the smallest scale SetRenderScale() allows - and so the furthest ResolutionScaler drops to)
+    static constexpr float MinRenderScale = 0.25f;
 };
 
 #endif /* Graphics_hpp */
@@ -0,0 +1,254 @@
+//
+//  Interpolants.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef Interpolants_hpp
+#define Interpolants_hpp
+
+#include <array>
+#include <vector>
+#include <initializer_list>
+#include <cassert>
+#include "Vec2.hpp"
+#include "Vec3.hpp"
+#include "Simd.hpp"
+
+// a fixed number of float attributes (texture coordinates, colors, etc.) that are interpolated
+// together across a triangle - an effect names them with its own indices (e.g. an enum)
+// the floats are aligned and padded out to a multiple of 4, and every operation is one loop
+// over all of them, 4 at a time (with no temporary objects built member by member)
+template <size_t N>
+class Interpolants
+{
+public:
+    static constexpr size_t Size = N;
+    
+    Interpolants() = default;
+    Interpolants(std::initializer_list<float> values)
+    {
+        assert(values.size() <= N);
+        size_t i = 0;
+        for (float f : values)
+            data[i++] = f;
+    }
+    float& operator[](size_t i) { return data[i]; }
+    const float& operator[](size_t i) const { return data[i]; }
+    // (for attributes that are naturally vectors - the 2 or 3 floats starting at index i)
+    Vec2 GetVec2(size_t i) const { return Vec2(data[i], data[i + 1]); }
+    Vec3 GetVec3(size_t i) const { return Vec3(data[i], data[i + 1], data[i + 2]); }
+    void Set(size_t i, const Vec2& v)
+    {
+        data[i] = v.x;
+        data[i + 1] = v.y;
+    }
+    void Set(size_t i, const Vec3& v)
+    {
+        data[i] = v.x;
+        data[i + 1] = v.y;
+        data[i + 2] = v.z;
+    }
+    
+    Interpolants& operator+=(const Interpolants& rhs)
+    {
+#ifdef SIMD_SSE2
+        for (size_t i = 0; i < Padded; i += 4)
+            _mm_store_ps(&data[i], _mm_add_ps(_mm_load_ps(&data[i]), _mm_load_ps(&rhs.data[i])));
+#else
+        for (size_t i = 0; i < Padded; i++)
+            data[i] += rhs.data[i];
+#endif
+        return *this;
+    }
+    Interpolants& operator-=(const Interpolants& rhs)
+    {
+#ifdef SIMD_SSE2
+        for (size_t i = 0; i < Padded; i += 4)
+            _mm_store_ps(&data[i], _mm_sub_ps(_mm_load_ps(&data[i]), _mm_load_ps(&rhs.data[i])));
+#else
+        for (size_t i = 0; i < Padded; i++)
+            data[i] -= rhs.data[i];
+#endif
+        return *this;
+    }
+    Interpolants& operator*=(float rhs)
+    {
+#ifdef SIMD_SSE2
+        const __m128 s = _mm_set1_ps(rhs);
+        for (size_t i = 0; i < Padded; i += 4)
+            _mm_store_ps(&data[i], _mm_mul_ps(_mm_load_ps(&data[i]), s));
+#else
+        for (size_t i = 0; i < Padded; i++)
+            data[i] *= rhs;
+#endif
+        return *this;
+    }
+    Interpolants& operator/=(float rhs)
+    {
+#ifdef SIMD_SSE2
+        const __m128 s = _mm_set1_ps(rhs);
+        for (size_t i = 0; i < Padded; i += 4)
+            _mm_store_ps(&data[i], _mm_div_ps(_mm_load_ps(&data[i]), s));
+#else
+        for (size_t i = 0; i < Padded; i++)
+            data[i] /= rhs;
+#endif
+        return *this;
+    }
+    Interpolants operator+(const Interpolants& rhs) const
+    {
+        Interpolants res = *this;
+        res += rhs;
+        return res;
+    }
+    Interpolants operator-(const Interpolants& rhs) const
+    {
+        Interpolants res = *this;
+        res -= rhs;
+        return res;
+    }
+    Interpolants operator*(float rhs) const
+    {
+        Interpolants res = *this;
+        res *= rhs;
+        return res;
+    }
+    Interpolants operator/(float rhs) const
+    {
+        Interpolants res = *this;
+        res /= rhs;
+        return res;
+    }
+    Interpolants InterpTo(const Interpolants& rhs, float percent) const
+    {
+        return (*this + (rhs - *this) * percent);
+    }
+    
+private:
+    static constexpr size_t Padded = (N + 3) / 4 * 4;
+    // (the padding is kept at zero, so it never holds anything that's slow to work on)
+    alignas(16) std::array<float, Padded> data{};
+};
+
+// the interpolated attributes of a run of pixels, as a structure of arrays - all of the first
+// attribute, then all of the second, etc. - so that a pixel shader working on a whole span (see
+// UsesSpans) can load the same attribute of several pixels at once
+template <size_t N>
+class InterpolantSpan
+{
+public:
+    static constexpr size_t Size = N;
+    
+    void Resize(int n)
+    {
+        for (auto& a : attr)
+            a.resize(n);
+    }
+    void Set(int i, const Interpolants<N>& values)
+    {
+        for (size_t k = 0; k < N; k++)
+            attr[k][i] = values[k];
+    }
+    // (all of the given attribute, one float per pixel)
+    float* operator[](size_t k) { return attr[k].data(); }
+    const float* operator[](size_t k) const { return attr[k].data(); }
+    
+private:
+    std::array<std::vector<float>, N> attr;
+};
+
+// the screen-space derivatives at either end of a stretch of n pixels of a span, from pixel first
+// on - the end being steps pixels along from the first (in between, they're taken to change
+// linearly, as the attributes themselves are)
+template <typename Vertex>
+struct SpanStretch
+{
+    int first = 0;
+    int n = 0;
+    int steps = 0;
+    Vertex ddxStart{};
+    Vertex ddyStart{};
+    Vertex ddxEnd{};
+    Vertex ddyEnd{};
+};
+
+// (for vertices that have no flat attributes)
+struct NoFlatAttributes {};
+
+// a vertex with a position, N interpolated attributes (see Interpolants), and optionally some
+// flat attributes (e.g. a face normal), which are the same across the triangle - so aren't
+// interpolated, and are simply carried along
+// this has everything a pipeline needs from a vertex, so an effect can use it for its shaders'
+// output vertices rather than writing its own class
+template <size_t N, typename Flat = NoFlatAttributes>
+class InterpolatedVertex
+{
+public:
+    InterpolatedVertex() = default;
+    InterpolatedVertex(const Vec3& v, const Interpolants<N>& attr, const Flat& flat = Flat()):
+        v(v),
+        attr(attr),
+        flat(flat)
+    {}
+    InterpolatedVertex& operator+=(const InterpolatedVertex& rhs)
+    {
+        v += rhs.v;
+        attr += rhs.attr;
+        return *this;
+    }
+    InterpolatedVertex& operator-=(const InterpolatedVertex& rhs)
+    {
+        v -= rhs.v;
+        attr -= rhs.attr;
+        return *this;
+    }
+    InterpolatedVertex& operator*=(float rhs)
+    {
+        v *= rhs;
+        attr *= rhs;
+        return *this;
+    }
+    InterpolatedVertex& operator/=(float rhs)
+    {
+        v /= rhs;
+        attr /= rhs;
+        return *this;
+    }
+    InterpolatedVertex operator+(const InterpolatedVertex& rhs) const
+    {
+        InterpolatedVertex res = *this;
+        res += rhs;
+        return res;
+    }
+    InterpolatedVertex operator-(const InterpolatedVertex& rhs) const
+    {
+        InterpolatedVertex res = *this;
+        res -= rhs;
+        return res;
+    }
+    InterpolatedVertex operator*(float rhs) const
+    {
+        InterpolatedVertex res = *this;
+        res *= rhs;
+        return res;
+    }
+    InterpolatedVertex operator/(float rhs) const
+    {
+        InterpolatedVertex res = *this;
+        res /= rhs;
+        return res;
+    }
+    InterpolatedVertex InterpTo(const InterpolatedVertex& rhs, float percent) const
+    {
+        return { v.InterpTo(rhs.v, percent), attr.InterpTo(rhs.attr, percent), flat };
+    }
+    
+    Vec3 v;
+    Interpolants<N> attr;
+    Flat flat;
+};
+
+#endif /* Interpolants_hpp */
@@ -0,0 +1,80 @@
+//
+//  MappedFile.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include "MappedFile.hpp"
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+MappedFile::MappedFile(const std::string& filename)
+{
+    HANDLE hF = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hF == INVALID_HANDLE_VALUE)
+        return;
+    hFile = hF;
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hF, &fileSize) || fileSize.QuadPart == 0)
+        return;
+    
+    hMapping = CreateFileMappingA(hF, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (hMapping == NULL)
+        return;
+    
+    pData = static_cast<unsigned char*>(MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0));
+    if (pData)
+        size = static_cast<size_t>(fileSize.QuadPart);
+}
+
+MappedFile::~MappedFile()
+{
+    if (pData)
+        UnmapViewOfFile(pData);
+    if (hMapping)
+        CloseHandle(hMapping);
+    if (hFile)
+        CloseHandle(hFile);
+}
+
+#else
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* p = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            pData = static_cast<unsigned char*>(p);
+            size = static_cast<size_t>(st.st_size);
+        }
+    }
+    
+    // (the mapping stays valid after the file is closed)
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (pData)
+        munmap(pData, size);
+}
+
+#endif
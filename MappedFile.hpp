@@ -0,0 +1,39 @@
+//
+//  MappedFile.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef MappedFile_hpp
+#define MappedFile_hpp
+
+#include <string>
+#include <cstddef>
+
+// maps an entire file into memory, so that its contents are paged in by the OS on first access
+// rather than read up front
+// the mapping is copy-on-write - writes through it are allowed, but are never written back to
+// the file
+class MappedFile
+{
+public:
+    MappedFile(const std::string& filename);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    // (returns null if the file could not be mapped)
+    unsigned char* Data() const { return pData; }
+    size_t Size() const { return size; }
+    ~MappedFile();
+    
+private:
+    unsigned char* pData = nullptr;
+    size_t size = 0;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    void* hFile = nullptr;
+    void* hMapping = nullptr;
+#endif
+};
+
+#endif /* MappedFile_hpp */
@@ -11,20 +11,31 @@
 
 #include "Vec3.hpp"
 
+// vectors are rows, multiplied on the left (v * m) - each row of the matrix is padded out to 4
+// components, like Vec3, so that a float matrix is 3 SSE registers
 template<typename T>
 class _Mat3
 {
 public:
     _Mat3() = default;
-    _Mat3<T> operator+(const _Mat3<T>& rhs)
+    _Mat3(T m00, T m01, T m02,
+          T m10, T m11, T m12,
+          T m20, T m21, T m22):
+        data{ { m00, m01, m02, z },
+              { m10, m11, m12, z },
+              { m20, m21, m22, z } }
+    {}
+    _Mat3<T> operator+(const _Mat3<T>& rhs) const
     {
+        _Mat3<T> ret = *this;
         for (size_t i = 0; i < 3; i++)
         {
             for (size_t j = 0; j < 3; j++)
             {
-                data[i][j] += rhs[i][j];
+                ret.data[i][j] += rhs.data[i][j];
             }
         }
+        return ret;
     }
     _Mat3<T>& operator+=(const _Vec3<T>& rhs)
     {
@@ -33,10 +44,25 @@ public:
         data[2][2] += rhs.z;
         return *this;
     }
-    _Mat3<T> operator*(const _Mat3<T>& rhs)
+    _Mat3<T> operator*(const _Mat3<T>& rhs) const
     {
         _Mat3<T> ret;
-        
+
+#ifdef SIMD_SSE2
+        if constexpr (_Vec3<T>::IsSimd)
+        {
+            // each output row is a weighted sum of this matrix's rows
+            for (size_t r = 0; r < 3; r++)
+            {
+                __m128 row = _mm_setzero_ps();
+                for (size_t i = 0; i < 3; i++)
+                    row = _mm_add_ps(row, _mm_mul_ps(_mm_load_ps(data[i]), _mm_set1_ps(rhs.data[r][i])));
+                _mm_store_ps(ret.data[r], row);
+            }
+            return ret;
+        }
+#endif
+
         // loop through rows (r) and columns (c) for the *output* matrix
         for (size_t r = 0; r < 3; r++)
         {
@@ -46,8 +72,9 @@ public:
                 for (size_t i = 0; i < 3; i++)
                     ret.data[r][c] += (data[i][c] * rhs.data[r][i]);
             }
+            ret.data[r][3] = z;
         }
-        
+
         return ret;
     }
     static _Mat3<T> Identity()
@@ -76,7 +103,7 @@ public:
         T c = static_cast<T>(cos(angle));
         return
         {
-            c, 0, -s,
+            c, z, -s,
             z, o, z,
             s, z, c
         };
@@ -94,17 +121,29 @@ public:
     }
 
     ~_Mat3() = default;
-    
+
 private:
     static constexpr T z = static_cast<T>(0);
     static constexpr T o = static_cast<T>(1);
 public:
-    T data[3][3];
+    // (the 4th column is padding, and always zero)
+    alignas(4 * sizeof(T)) T data[3][4];
 };
 
 template<typename T>
 _Vec3<T> operator*(const _Vec3<T>& lhs, const _Mat3<T>& rhs)
 {
+#ifdef SIMD_SSE2
+    if constexpr (_Vec3<T>::IsSimd)
+    {
+        // a weighted sum of the matrix's rows (in the same order as below)
+        __m128 v = lhs.ToSimd();
+        __m128 res = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), _mm_load_ps(rhs.data[0]));
+        res = _mm_add_ps(res, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), _mm_load_ps(rhs.data[1])));
+        res = _mm_add_ps(res, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), _mm_load_ps(rhs.data[2])));
+        return _Vec3<T>::FromSimd(res);
+    }
+#endif
     _Vec3<T> res;
     res.x = lhs.x * rhs.data[0][0] + lhs.y * rhs.data[1][0] + lhs.z * rhs.data[2][0];
     res.y = lhs.x * rhs.data[0][1] + lhs.y * rhs.data[1][1] + lhs.z * rhs.data[2][1];
@@ -0,0 +1,148 @@
+//
+//  Mat4.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef Mat4_hpp
+#define Mat4_hpp
+
+#include "Vec3.hpp"
+#include "Vec4.hpp"
+#include "Mat3.hpp"
+
+// a homogeneous transform - as with Mat3, vectors are rows, multiplied on the left (v * m), so
+// translation lives in the bottom row
+template<typename T>
+class _Mat4
+{
+public:
+    _Mat4() = default;
+    _Mat4(T m00, T m01, T m02, T m03,
+          T m10, T m11, T m12, T m13,
+          T m20, T m21, T m22, T m23,
+          T m30, T m31, T m32, T m33):
+        data{ { m00, m01, m02, m03 },
+              { m10, m11, m12, m13 },
+              { m20, m21, m22, m23 },
+              { m30, m31, m32, m33 } }
+    {}
+    // (a * b applies b's transform first, then a's - as with Mat3)
+    _Mat4<T> operator*(const _Mat4<T>& rhs) const
+    {
+        _Mat4<T> ret;
+
+#ifdef SIMD_SSE2
+        if constexpr (_Vec4<T>::IsSimd)
+        {
+            // each output row is a weighted sum of this matrix's rows
+            for (size_t r = 0; r < 4; r++)
+            {
+                __m128 row = _mm_setzero_ps();
+                for (size_t i = 0; i < 4; i++)
+                    row = _mm_add_ps(row, _mm_mul_ps(_mm_load_ps(data[i]), _mm_set1_ps(rhs.data[r][i])));
+                _mm_store_ps(ret.data[r], row);
+            }
+            return ret;
+        }
+#endif
+
+        // loop through rows (r) and columns (c) for the *output* matrix
+        for (size_t r = 0; r < 4; r++)
+        {
+            for (size_t c = 0; c < 4; c++)
+            {
+                ret.data[r][c] = z;
+                for (size_t i = 0; i < 4; i++)
+                    ret.data[r][c] += (data[i][c] * rhs.data[r][i]);
+            }
+        }
+
+        return ret;
+    }
+    static _Mat4<T> Identity()
+    {
+        return
+        {
+            o, z, z, z,
+            z, o, z, z,
+            z, z, o, z,
+            z, z, z, o
+        };
+    }
+    static _Mat4<T> Scaling(T sx, T sy, T sz)
+    {
+        return
+        {
+            sx, z, z, z,
+            z, sy, z, z,
+            z, z, sz, z,
+            z, z, z, o
+        };
+    }
+    static _Mat4<T> Translation(const _Vec3<T>& t)
+    {
+        return
+        {
+            o, z, z, z,
+            z, o, z, z,
+            z, z, o, z,
+            t.x, t.y, t.z, o
+        };
+    }
+    // rotates (or otherwise transforms) by m, then translates by t
+    static _Mat4<T> Affine(const _Mat3<T>& m, const _Vec3<T>& t)
+    {
+        return
+        {
+            m.data[0][0], m.data[0][1], m.data[0][2], z,
+            m.data[1][0], m.data[1][1], m.data[1][2], z,
+            m.data[2][0], m.data[2][1], m.data[2][2], z,
+            t.x, t.y, t.z, o
+        };
+    }
+
+    ~_Mat4() = default;
+
+private:
+    static constexpr T z = static_cast<T>(0);
+    static constexpr T o = static_cast<T>(1);
+public:
+    alignas(4 * sizeof(T)) T data[4][4];
+};
+
+template<typename T>
+_Vec4<T> operator*(const _Vec4<T>& lhs, const _Mat4<T>& rhs)
+{
+#ifdef SIMD_SSE2
+    if constexpr (_Vec4<T>::IsSimd)
+    {
+        // a weighted sum of the matrix's rows (in the same order as below)
+        __m128 v = lhs.ToSimd();
+        __m128 res = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), _mm_load_ps(rhs.data[0]));
+        res = _mm_add_ps(res, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), _mm_load_ps(rhs.data[1])));
+        res = _mm_add_ps(res, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), _mm_load_ps(rhs.data[2])));
+        res = _mm_add_ps(res, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), _mm_load_ps(rhs.data[3])));
+        return _Vec4<T>::FromSimd(res);
+    }
+#endif
+    _Vec4<T> res;
+    res.x = lhs.x * rhs.data[0][0] + lhs.y * rhs.data[1][0] + lhs.z * rhs.data[2][0] + lhs.w * rhs.data[3][0];
+    res.y = lhs.x * rhs.data[0][1] + lhs.y * rhs.data[1][1] + lhs.z * rhs.data[2][1] + lhs.w * rhs.data[3][1];
+    res.z = lhs.x * rhs.data[0][2] + lhs.y * rhs.data[1][2] + lhs.z * rhs.data[2][2] + lhs.w * rhs.data[3][2];
+    res.w = lhs.x * rhs.data[0][3] + lhs.y * rhs.data[1][3] + lhs.z * rhs.data[2][3] + lhs.w * rhs.data[3][3];
+    return res;
+}
+
+template<typename T>
+_Vec4<T>& operator*=(_Vec4<T>& lhs, const _Mat4<T>& rhs)
+{
+    lhs = lhs * rhs;
+    return lhs;
+}
+
+typedef _Mat4<float> Mat4;
+
+#endif /* Mat4_hpp */
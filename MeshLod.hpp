@@ -0,0 +1,95 @@
+//
+//  MeshLod.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef MeshLod_hpp
+#define MeshLod_hpp
+
+#include <vector>
+#include <cassert>
+#include <limits>
+#include <algorithm>
+#include "Vec3.hpp"
+#include "IndexedTriangleList.hpp"
+#include "BoundingBox.hpp"
+#include "MeshStreams.hpp"
+
+// several versions of a mesh at decreasing levels of detail (e.g. a sphere at fewer and fewer
+// tessellations, or simplified versions of a loaded mesh), one of which is picked for each draw
+// from how big the mesh appears on screen - so that a mesh covering a handful of pixels doesn't
+// cost as much as one covering the whole screen
+// the chain itself can be shared between any number of objects, each of which keeps track of
+// the level it was last drawn at (see SelectLevel())
+template <typename Vertex>
+class MeshLod
+{
+public:
+    // levels are added from most to least detailed, each with the smallest screen size (see
+    // ScreenSize()) that it is to be drawn at - the least detailed level is used for anything
+    // smaller than that, whatever it was added with
+    void AddLevel(IndexedTriangleList<Vertex> itl, float minScreenSize)
+    {
+        assert(levels.empty() || minScreenSize <= levels.back().minScreenSize);
+
+        // (the bounds are taken from the most detailed level, which the others approximate)
+        if (levels.empty())
+        {
+            for (const auto& v : itl.vertices)
+            {
+                boundingRadius = std::max(boundingRadius, v.v.Mag());
+                boundingBox.Add(v.v);
+            }
+        }
+
+        MeshStreams streams(itl.vertices);
+        levels.push_back({ std::move(itl), std::move(streams), minScreenSize });
+    }
+    int NumLevels() const { return static_cast<int>(levels.size()); }
+    const IndexedTriangleList<Vertex>& GetLevel(int level) const { return levels[level].itl; }
+    // (the level's vertices gathered for batched vertex shaders, once when the level is added)
+    const MeshStreams& GetStreams(int level) const { return levels[level].streams; }
+    // (around the mesh's origin, in model space)
+    float GetBoundingRadius() const { return boundingRadius; }
+    const BoundingBox& GetBoundingBox() const { return boundingBox; }
+
+    // the diameter, in pixels, of the mesh's bounding sphere when drawn the given distance from
+    // the camera, into a screen of the given width (x from -1 to +1 at a distance of 1 spans the
+    // whole width - see ScreenTransform)
+    float ScreenSize(float distance, int screenWidth) const
+    {
+        return (distance > 0.0f) ? boundingRadius / distance * static_cast<float>(screenWidth) : std::numeric_limits<float>::infinity();
+    }
+    // picks the level to draw at, given the level last drawn at - a level only changes once the
+    // screen size is well past the threshold between them (see Hysteresis), so that a mesh
+    // hovering around a threshold doesn't keep popping between levels
+    int SelectLevel(float screenSize, int currentLevel) const
+    {
+        assert(!levels.empty());
+        int level = std::clamp(currentLevel, 0, NumLevels() - 1);
+        while (level > 0 && screenSize >= levels[level - 1].minScreenSize * (1.0f + Hysteresis))
+            level--;
+        while (level < NumLevels() - 1 && screenSize < levels[level].minScreenSize * (1.0f - Hysteresis))
+            level++;
+        return level;
+    }
+    // (the fraction of a threshold that the screen size must go past it by)
+    static constexpr float Hysteresis = 0.15f;
+
+private:
+    struct Level
+    {
+        IndexedTriangleList<Vertex> itl;
+        MeshStreams streams;
+        float minScreenSize;
+    };
+
+    std::vector<Level> levels;
+    float boundingRadius = 0.0f;
+    BoundingBox boundingBox;
+};
+
+#endif /* MeshLod_hpp */
@@ -0,0 +1,393 @@
+//
+//  MeshSimplifier.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <utility>
+#include <cmath>
+#include "MeshSimplifier.hpp"
+
+// the sum of squared distances from a point to a set of planes, as a symmetric 4x4 matrix (of
+// which only the 10 distinct elements are kept) - in double precision, as a quadric may sum up
+// the planes of a great many triangles by the time it is done
+struct MeshSimplifier::Quadric
+{
+    double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+    double b2 = 0.0, bc = 0.0, bd = 0.0;
+    double c2 = 0.0, cd = 0.0;
+    double d2 = 0.0;
+
+    // (the plane ax + by + cz + d = 0, with a unit normal, and weighted - e.g. by area)
+    static Quadric FromPlane(double a, double b, double c, double d, double weight)
+    {
+        Quadric q;
+        q.a2 = weight * a * a; q.ab = weight * a * b; q.ac = weight * a * c; q.ad = weight * a * d;
+        q.b2 = weight * b * b; q.bc = weight * b * c; q.bd = weight * b * d;
+        q.c2 = weight * c * c; q.cd = weight * c * d;
+        q.d2 = weight * d * d;
+        return q;
+    }
+    Quadric& operator+=(const Quadric& rhs)
+    {
+        a2 += rhs.a2; ab += rhs.ab; ac += rhs.ac; ad += rhs.ad;
+        b2 += rhs.b2; bc += rhs.bc; bd += rhs.bd;
+        c2 += rhs.c2; cd += rhs.cd;
+        d2 += rhs.d2;
+        return *this;
+    }
+    double Error(const Vec3& p) const
+    {
+        double x = p.x, y = p.y, z = p.z;
+        return a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x +
+               b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y +
+               c2 * z * z + 2.0 * cd * z +
+               d2;
+    }
+};
+
+// merging one group of vertices into another (the other end of an edge)
+struct MeshSimplifier::Collapse
+{
+    size_t from;
+    size_t to;
+    double cost;
+};
+
+// collapses are made in passes - each pass finds the cost of collapsing every edge, and then
+// makes the cheapest ones, skipping any near one already made in the pass (whose costs are out
+// of date until the next pass) - which is much quicker than keeping every cost up to date
+// after each collapse, for nearly the same result
+// all of this works on groups of vertices that share a position (see GroupByPosition()) rather
+// than on the vertices themselves, so that a seam is collapsed as one
+std::vector<IndexedTriangle> MeshSimplifier::SimplifyTriangles(const std::vector<Vec3>& positions,
+                                                               const std::vector<IndexedTriangle>& triangles,
+                                                               size_t targetTriangles)
+{
+    std::vector<IndexedTriangle> tris = triangles;
+    if (tris.size() <= targetTriangles)
+        return tris;
+
+    const size_t numVertices = positions.size();
+    std::vector<size_t> group;
+    const size_t numGroups = GroupByPosition(positions, group);
+    std::vector<Vec3> groupPositions(numGroups);
+    for (size_t i = 0; i < numVertices; i++)
+        groupPositions[group[i]] = positions[i];
+
+    // (the triangles with their vertices' groups in place of the vertices)
+    std::vector<IndexedTriangle> groupTris(tris.size());
+    auto findGroupTris = [&]()
+    {
+        groupTris.resize(tris.size());
+        for (size_t k = 0; k < tris.size(); k++)
+            for (size_t e = 0; e < 3; e++)
+                groupTris[k].indices[e] = group[tris[k].indices[e]];
+    };
+    findGroupTris();
+    const std::vector<char> locked = FindLocked(numGroups, groupTris);
+
+    // each group starts with the planes of the triangles around it, weighted by their areas (so
+    // that the cost of a collapse is roughly the volume it changes)
+    std::vector<Quadric> quadrics(numGroups);
+    for (const auto& t : groupTris)
+    {
+        const Vec3& p0 = groupPositions[t.indices[0]];
+        Vec3 n = (groupPositions[t.indices[1]] - p0).cross(groupPositions[t.indices[2]] - p0);
+        double len = n.Mag();
+        if (len == 0.0)
+            continue;
+        double a = n.x / len, b = n.y / len, c = n.z / len;
+        Quadric q = Quadric::FromPlane(a, b, c, -(a * p0.x + b * p0.y + c * p0.z), len * 0.5);
+        for (size_t i : t.indices)
+            quadrics[i] += q;
+    }
+
+    std::vector<size_t> adjOffsets;
+    std::vector<size_t> adjTriangles;
+    std::vector<Collapse> collapses;
+    std::vector<char> touched;
+    std::vector<size_t> remap;
+    std::vector<std::pair<size_t, size_t>> moves;
+    std::vector<size_t> neighborsFrom;
+    std::vector<size_t> neighborsTo;
+
+    auto normal = [&](const IndexedTriangle& t)
+    {
+        const Vec3& p0 = groupPositions[t.indices[0]];
+        return (groupPositions[t.indices[1]] - p0).cross(groupPositions[t.indices[2]] - p0);
+    };
+    auto contains = [](const IndexedTriangle& t, size_t i)
+    {
+        return t.indices[0] == i || t.indices[1] == i || t.indices[2] == i;
+    };
+    auto gatherNeighbors = [&](size_t v, std::vector<size_t>& neighbors)
+    {
+        neighbors.clear();
+        for (size_t k = adjOffsets[v]; k < adjOffsets[v + 1]; k++)
+            for (size_t i : groupTris[adjTriangles[k]].indices)
+                if (i != v)
+                    neighbors.push_back(i);
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    };
+
+    // a collapse of one group into another is allowed if:
+    // - each vertex of the one group has a partner in the other that it shares an edge with, to
+    //   be merged into (otherwise the collapse would run off a seam, and tear it open)
+    // - it doesn't flip (or turn too far - see MinNormalCosSq) any of the triangles that are
+    //   moved, and doesn't fold any of them back over the triangles already around the group
+    //   they're moved to
+    // - the only groups next to both ends are across the triangles being removed (otherwise the
+    //   mesh would be pinched together there)
+    // moves is set to the vertices to merge, and shared to the number of triangles removed
+    auto canCollapse = [&](size_t from, size_t to, size_t& shared)
+    {
+        shared = 0;
+        moves.clear();
+        for (size_t k = adjOffsets[from]; k < adjOffsets[from + 1]; k++)
+        {
+            const IndexedTriangle& gt = groupTris[adjTriangles[k]];
+            if (!contains(gt, to))
+                continue;
+            shared++;
+            const IndexedTriangle& t = tris[adjTriangles[k]];
+            size_t a = 0, b = 0;
+            for (size_t e = 0; e < 3; e++)
+            {
+                if (gt.indices[e] == from)
+                    a = t.indices[e];
+                else if (gt.indices[e] == to)
+                    b = t.indices[e];
+            }
+            moves.emplace_back(a, b);
+        }
+        std::sort(moves.begin(), moves.end());
+        moves.erase(std::unique(moves.begin(), moves.end()), moves.end());
+        for (size_t i = 1; i < moves.size(); i++)
+            if (moves[i].first == moves[i - 1].first)
+                return false;
+        auto partnered = [&](size_t v)
+        {
+            for (const auto& m : moves)
+                if (m.first == v)
+                    return true;
+            return false;
+        };
+
+        const Vec3& pTo = groupPositions[to];
+        for (size_t k = adjOffsets[from]; k < adjOffsets[from + 1]; k++)
+        {
+            const IndexedTriangle& gt = groupTris[adjTriangles[k]];
+            if (contains(gt, to))
+                continue;
+
+            const IndexedTriangle& t = tris[adjTriangles[k]];
+            for (size_t e = 0; e < 3; e++)
+                if (gt.indices[e] == from && !partnered(t.indices[e]))
+                    return false;
+
+            const Vec3& p0 = groupPositions[gt.indices[0]];
+            const Vec3& p1 = groupPositions[gt.indices[1]];
+            const Vec3& p2 = groupPositions[gt.indices[2]];
+            Vec3 before = (p1 - p0).cross(p2 - p0);
+            const Vec3& q0 = (gt.indices[0] == from) ? pTo : p0;
+            const Vec3& q1 = (gt.indices[1] == from) ? pTo : p1;
+            const Vec3& q2 = (gt.indices[2] == from) ? pTo : p2;
+            Vec3 after = (q1 - q0).cross(q2 - q0);
+            // (in double precision, as the products of tiny triangles' areas would underflow)
+            double dot = before * after;
+            if (!(dot > 0.0) || dot * dot < MinNormalCosSq * static_cast<double>(before.MagSq()) * after.MagSq())
+                return false;
+            // (nor may it face away from any triangle already around the group it's moved to -
+            // just checking each triangle against itself lets small turns add up, over a few
+            // collapses, to a triangle facing the wrong way)
+            for (size_t j = adjOffsets[to]; j < adjOffsets[to + 1]; j++)
+            {
+                const IndexedTriangle& other = groupTris[adjTriangles[j]];
+                if (!contains(other, from) && !(normal(other) * after >= 0.0f))
+                    return false;
+            }
+        }
+
+        // (and a group across a removed triangle loses one of its triangles, so it mustn't be
+        // left with fewer than 3 - e.g. when the mesh is down to a tetrahedron, which would
+        // collapse into two triangles back to back)
+        gatherNeighbors(from, neighborsFrom);
+        gatherNeighbors(to, neighborsTo);
+        size_t common = 0;
+        for (size_t i = 0, j = 0; i < neighborsFrom.size() && j < neighborsTo.size(); )
+        {
+            if (neighborsFrom[i] < neighborsTo[j])
+            {
+                i++;
+            }
+            else if (neighborsTo[j] < neighborsFrom[i])
+            {
+                j++;
+            }
+            else
+            {
+                size_t v = neighborsFrom[i];
+                if (adjOffsets[v + 1] - adjOffsets[v] <= 3)
+                    return false;
+                common++;
+                i++;
+                j++;
+            }
+        }
+        return common == shared;
+    };
+
+    while (tris.size() > targetTriangles)
+    {
+        FindAdjacency(numGroups, groupTris, adjOffsets, adjTriangles);
+
+        // each edge once (from the triangle that has it running from the lower group to the
+        // higher), collapsed whichever way is allowed and cheaper
+        collapses.clear();
+        for (const auto& t : groupTris)
+        {
+            for (size_t e = 0; e < 3; e++)
+            {
+                size_t a = t.indices[e];
+                size_t b = t.indices[(e + 1) % 3];
+                if (a > b || (locked[a] && locked[b]))
+                    continue;
+
+                Quadric q = quadrics[a];
+                q += quadrics[b];
+                double costAB = locked[a] ? std::numeric_limits<double>::infinity() : q.Error(groupPositions[b]);
+                double costBA = locked[b] ? std::numeric_limits<double>::infinity() : q.Error(groupPositions[a]);
+                collapses.push_back((costAB <= costBA) ? Collapse{ a, b, costAB } : Collapse{ b, a, costBA });
+            }
+        }
+        if (collapses.empty())
+            break;
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse& lhs, const Collapse& rhs) { return lhs.cost < rhs.cost; });
+
+        touched.assign(numGroups, 0);
+        remap.resize(numVertices);
+        std::iota(remap.begin(), remap.end(), size_t(0));
+        const size_t toRemove = tris.size() - targetTriangles;
+        size_t removed = 0;
+        size_t numCollapsed = 0;
+        for (size_t i = 0; i < collapses.size() && removed < toRemove; i++)
+        {
+            // (the more expensive half is left for the next pass - by then, the collapses made in
+            // this pass will usually have made cheaper ones available)
+            if (i > collapses.size() / 2 && numCollapsed > 0)
+                break;
+
+            const Collapse& c = collapses[i];
+            size_t shared;
+            if (touched[c.from] || touched[c.to] || !canCollapse(c.from, c.to, shared))
+                continue;
+
+            for (const auto& m : moves)
+                remap[m.first] = m.second;
+            quadrics[c.to] += quadrics[c.from];
+            for (size_t k = adjOffsets[c.from]; k < adjOffsets[c.from + 1]; k++)
+                for (size_t v : groupTris[adjTriangles[k]].indices)
+                    touched[v] = 1;
+            removed += shared;
+            numCollapsed++;
+        }
+        if (numCollapsed == 0)
+            break;
+
+        // move the collapsed vertices' triangles over, and drop the ones with nothing left
+        size_t numKept = 0;
+        for (size_t k = 0; k < tris.size(); k++)
+        {
+            IndexedTriangle t = tris[k];
+            for (auto& i : t.indices)
+                i = remap[i];
+            if (t.indices[0] != t.indices[1] && t.indices[1] != t.indices[2] && t.indices[2] != t.indices[0])
+                tris[numKept++] = t;
+        }
+        tris.resize(numKept);
+        findGroupTris();
+    }
+
+    return tris;
+}
+
+// numbers the distinct positions, setting group to the number of each vertex's position - and
+// returns how many there are
+size_t MeshSimplifier::GroupByPosition(const std::vector<Vec3>& positions, std::vector<size_t>& group)
+{
+    // (sorted by position, vertices that share a position end up next to each other)
+    std::vector<size_t> order(positions.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    auto byPosition = [&](size_t a, size_t b)
+    {
+        const Vec3& pa = positions[a];
+        const Vec3& pb = positions[b];
+        return (pa.x != pb.x) ? pa.x < pb.x : (pa.y != pb.y) ? pa.y < pb.y : pa.z < pb.z;
+    };
+    std::sort(order.begin(), order.end(), byPosition);
+
+    group.resize(positions.size());
+    size_t numGroups = 0;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        if (i > 0 && byPosition(order[i - 1], order[i]))
+            numGroups++;
+        group[order[i]] = numGroups;
+    }
+    return order.empty() ? 0 : numGroups + 1;
+}
+
+// finds the groups that must never be removed - those on borders (on an edge used by only one
+// triangle, or by more than two) - from the triangles with the groups of their vertices
+std::vector<char> MeshSimplifier::FindLocked(size_t numGroups, const std::vector<IndexedTriangle>& triangles)
+{
+    std::vector<char> locked(numGroups, 0);
+
+    // (sorted, the uses of each edge end up next to each other)
+    std::vector<std::pair<size_t, size_t>> edges;
+    edges.reserve(triangles.size() * 3);
+    for (const auto& t : triangles)
+        for (size_t e = 0; e < 3; e++)
+            edges.push_back(std::minmax(t.indices[e], t.indices[(e + 1) % 3]));
+    std::sort(edges.begin(), edges.end());
+    for (size_t i = 0; i < edges.size(); )
+    {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j] == edges[i])
+            j++;
+        if (j - i != 2)
+        {
+            locked[edges[i].first] = 1;
+            locked[edges[i].second] = 1;
+        }
+        i = j;
+    }
+
+    return locked;
+}
+
+// lists the triangles around each vertex - those around vertex v are
+// adjacent[offsets[v]] up to (but not including) adjacent[offsets[v + 1]]
+void MeshSimplifier::FindAdjacency(size_t numVertices, const std::vector<IndexedTriangle>& triangles,
+                                   std::vector<size_t>& offsets, std::vector<size_t>& adjacent)
+{
+    offsets.assign(numVertices + 1, 0);
+    for (const auto& t : triangles)
+        for (size_t i : t.indices)
+            offsets[i + 1]++;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    adjacent.resize(triangles.size() * 3);
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t k = 0; k < triangles.size(); k++)
+        for (size_t i : triangles[k].indices)
+            adjacent[next[i]++] = k;
+}
@@ -0,0 +1,112 @@
+//
+//  MeshSimplifier.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef MeshSimplifier_hpp
+#define MeshSimplifier_hpp
+
+#include <vector>
+#include <cstddef>
+#include "Vec3.hpp"
+#include "IndexedTriangleList.hpp"
+#include "MeshLod.hpp"
+
+// builds lower detail versions of a mesh (e.g. at asset import, for a MeshLod), by collapsing
+// edges - merging one end of an edge into the other - in the order that changes the shape of the
+// mesh the least, as measured by quadric error metrics (Garland & Heckbert)
+// vertices are only ever removed, never moved or blended, so this works for any vertex type and
+// the attributes of the vertices that remain are exact
+// vertices that share a position (on an attribute seam, e.g. the corners of a mesh whose faces
+// each have their own texture coordinates) are collapsed together, each into its own partner at
+// the other end of the edge - so only along the seam, or away from it entirely, which keeps the
+// seam closed - and vertices on the border of an open mesh are never removed, so borders keep
+// their shape
+class MeshSimplifier
+{
+public:
+    MeshSimplifier() = delete;
+    ~MeshSimplifier() = delete;
+
+    // collapses edges until there are no more than the given number of triangles (or until
+    // nothing more can be collapsed without folding the mesh over) - vertices no longer used by
+    // any triangle are dropped
+    template <typename Vertex>
+    static IndexedTriangleList<Vertex> Simplify(const IndexedTriangleList<Vertex>& itl, size_t targetTriangles)
+    {
+        std::vector<Vec3> positions;
+        positions.reserve(itl.vertices.size());
+        for (const auto& v : itl.vertices)
+            positions.push_back(Position(v));
+
+        IndexedTriangleList<Vertex> res;
+        res.triangles = SimplifyTriangles(positions, itl.triangles, targetTriangles);
+
+        // (the vertices that are left keep their order)
+        std::vector<size_t> remap(itl.vertices.size(), Unused);
+        for (auto& t : res.triangles)
+        {
+            for (auto& i : t.indices)
+            {
+                if (remap[i] == Unused)
+                {
+                    remap[i] = res.vertices.size();
+                    res.vertices.push_back(itl.vertices[i]);
+                }
+                i = remap[i];
+            }
+        }
+        return res;
+    }
+
+    // a level to build for a level of detail chain - with the given fraction of the full mesh's
+    // triangles, drawn down to the given screen size (see MeshLod::AddLevel())
+    struct LodTarget
+    {
+        float ratio;
+        float minScreenSize;
+    };
+    // (each level is simplified from the one before it, rather than from the full mesh, which is
+    // much quicker for long chains)
+    template <typename Vertex>
+    static MeshLod<Vertex> BuildLod(const IndexedTriangleList<Vertex>& itl, const std::vector<LodTarget>& targets)
+    {
+        MeshLod<Vertex> lod;
+        IndexedTriangleList<Vertex> level = itl;
+        for (const auto& t : targets)
+        {
+            size_t targetTriangles = static_cast<size_t>(t.ratio * static_cast<float>(itl.triangles.size()));
+            if (targetTriangles < level.triangles.size())
+                level = Simplify(level, targetTriangles);
+            lod.AddLevel(level, t.minScreenSize);
+        }
+        return lod;
+    }
+
+private:
+    static constexpr size_t Unused = static_cast<size_t>(-1);
+    // (the square of the cosine of the furthest a triangle's normal may turn in one collapse -
+    // anything much further would usually be a triangle folding over or standing on edge)
+    static constexpr float MinNormalCosSq = 0.25f * 0.25f;
+
+    static const Vec3& Position(const Vec3& v) { return v; }
+    template <typename Vertex>
+    static const Vec3& Position(const Vertex& v) { return v.v; }
+
+    struct Quadric;
+    struct Collapse;
+
+    // (does the actual work, which only needs the vertices' positions)
+    static std::vector<IndexedTriangle> SimplifyTriangles(const std::vector<Vec3>& positions,
+                                                          const std::vector<IndexedTriangle>& triangles,
+                                                          size_t targetTriangles);
+    static size_t GroupByPosition(const std::vector<Vec3>& positions, std::vector<size_t>& group);
+    static std::vector<char> FindLocked(size_t numGroups, const std::vector<IndexedTriangle>& triangles);
+    static void FindAdjacency(size_t numVertices, const std::vector<IndexedTriangle>& triangles,
+                              std::vector<size_t>& offsets, std::vector<size_t>& adjacent);
+};
+
+#endif /* MeshSimplifier_hpp */
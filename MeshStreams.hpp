@@ -0,0 +1,48 @@
+//
+//  MeshStreams.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef MeshStreams_hpp
+#define MeshStreams_hpp
+
+#include <vector>
+#include "Vec3Stream.hpp"
+#include "EffectTraits.hpp"
+
+// a mesh's vertex positions (and normals, if its vertices have a norm member) gathered into
+// streams, for batched vertex shaders (see UsesBatches) to work on directly - built once along
+// with the mesh, rather than on every draw, as gathering them costs about as much as the
+// transform itself
+class MeshStreams
+{
+public:
+    MeshStreams() = default;
+    template <typename Vertex>
+    explicit MeshStreams(const std::vector<Vertex>& vertices)
+    {
+        Assign(vertices);
+    }
+    template <typename Vertex>
+    void Assign(const std::vector<Vertex>& vertices)
+    {
+        positions.Resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++)
+            positions.Set(i, vertices[i].v);
+        if constexpr (HasNormals<Vertex>::value)
+        {
+            normals.Resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++)
+                normals.Set(i, vertices[i].norm);
+        }
+    }
+    size_t Size() const { return positions.Size(); }
+
+    Vec3Stream positions;
+    Vec3Stream normals;
+};
+
+#endif /* MeshStreams_hpp */
@@ -0,0 +1,302 @@
+//
+//  OcclusionBuffer.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "OcclusionBuffer.hpp"
+#include "Simd.hpp"
+#include "VertexTransform.hpp"
+
+OcclusionBuffer::OcclusionBuffer(int w, int h):
+    w(w),
+    h(h),
+    pitch((w + 7 + 7) / 8 * 8),
+    halfW(static_cast<float>(w) / 2.0f),
+    halfH(static_cast<float>(h) / 2.0f),
+    depth(static_cast<size_t>(pitch) * h, 0.0f)
+{
+}
+
+void OcclusionBuffer::Clear()
+{
+    std::fill(depth.begin(), depth.end(), 0.0f);
+}
+
+// (pairs of triangles that make up a flat quad, e.g. the faces of a box, are drawn as the quad -
+// drawn as two triangles, the pixels along the diagonal between them would be left open, as
+// neither triangle covers all of them)
+void OcclusionBuffer::AddOccluder(const MeshStreams& streams, const std::vector<IndexedTriangle>& triangles,
+                                  const Mat3& rotMat, const Vec3& transVec)
+{
+    positions.Resize(streams.Size());
+    VertexTransform::Transform(streams.positions, rotMat, transVec, positions);
+    for (size_t i = 0; i < triangles.size(); i++)
+    {
+        Vec3 v[4];
+        if (i + 1 < triangles.size() && FormQuad(triangles[i], triangles[i + 1], v))
+        {
+            DrawConvex(v, 4);
+            i++;
+        }
+        else
+        {
+            for (int k = 0; k < 3; k++)
+                v[k] = positions.Get(triangles[i].indices[k]);
+            DrawConvex(v, 3);
+        }
+    }
+}
+
+// two triangles make a quad if they share an edge (running opposite ways around each, as it
+// does between triangles wound the same way) and lie in one plane - the quad runs around the
+// first triangle, then out to the second triangle's other vertex and back
+bool OcclusionBuffer::FormQuad(const IndexedTriangle& t1, const IndexedTriangle& t2, Vec3* pQuad) const
+{
+    for (int k = 0; k < 3; k++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            if (t2.indices[j] != t1.indices[(k + 1) % 3] || t2.indices[(j + 1) % 3] != t1.indices[k])
+                continue;
+            
+            pQuad[0] = positions.Get(t1.indices[(k + 2) % 3]);
+            pQuad[1] = positions.Get(t1.indices[k]);
+            pQuad[2] = positions.Get(t2.indices[(j + 2) % 3]);
+            pQuad[3] = positions.Get(t1.indices[(k + 1) % 3]);
+            
+            // (the second triangle's other vertex is in the plane of the first if it's no
+            // distance from it, relative to the size of the quad)
+            Vec3 norm = (pQuad[1] - pQuad[0]).cross(pQuad[3] - pQuad[0]);
+            Vec3 d = pQuad[2] - pQuad[0];
+            return fabsf(norm * d) <= PlanarTolerance * norm.Mag() * d.Mag();
+        }
+    }
+    return false;
+}
+
+// a half-space rasterizer - each row of the polygon's bounding box is worked through several
+// pixels at a time (8 with AVX2, 4 with SSE2), and a pixel is covered if all of it is on the
+// inside of every edge
+// (every pixel's values are worked out from scratch, in the same order whichever instruction
+// set is used, so the results are always the same)
+void OcclusionBuffer::DrawConvex(const Vec3* v, int n)
+{
+    for (int k = 0; k < n; k++)
+        if (v[k].z < NearZ)
+            return;
+
+    float x[4], y[4], iz[4];
+    for (int k = 0; k < n; k++)
+    {
+        x[k] = ScreenX(v[k]);
+        y[k] = ScreenY(v[k]);
+        iz[k] = 1.0f / v[k].z;
+    }
+
+    // (twice the signed area - the vertices are reversed if need be, so that the edge functions
+    // are positive inside the polygon whichever way it faces)
+    float area = 0.0f;
+    for (int k = 0; k < n; k++)
+        area += x[k] * y[(k + 1) % n] - x[(k + 1) % n] * y[k];
+    if (area == 0.0f)
+        return;
+    if (area < 0.0f)
+    {
+        std::reverse(x, x + n);
+        std::reverse(y, y + n);
+        std::reverse(iz, iz + n);
+    }
+
+    // edge functions e = a * x + b * y + c, for the edge from each vertex to the next
+    // (a triangle's fourth edge has everything inside it)
+    float a[4] = {}, b[4] = {}, c[4] = {};
+    for (int k = 0; k < n; k++)
+    {
+        int next = (k + 1) % n;
+        a[k] = y[k] - y[next];
+        b[k] = x[next] - x[k];
+        c[k] = x[k] * y[next] - x[next] * y[k];
+    }
+
+    // a quad that has been bent out of shape by projection (which only happens to one that isn't
+    // quite flat) is drawn as two triangles instead
+    if (n == 4)
+    {
+        for (int k = 0; k < n; k++)
+        {
+            if (a[k] * x[(k + 2) % n] + b[k] * y[(k + 2) % n] + c[k] <= 0.0f)
+            {
+                const Vec3 t1[3] = { v[0], v[1], v[2] };
+                const Vec3 t2[3] = { v[0], v[2], v[3] };
+                DrawConvex(t1, 3);
+                DrawConvex(t2, 3);
+                return;
+            }
+        }
+    }
+
+    // (a vertex just past NearZ can project far outside the range of an int, so coordinates are
+    // clamped before being converted)
+    int xMin = std::max(0, ToPixel(floorf(*std::min_element(x, x + n)), w));
+    int xMax = std::min(w - 1, ToPixel(ceilf(*std::max_element(x, x + n)), w));
+    int yMin = std::max(0, ToPixel(floorf(*std::min_element(y, y + n)), h));
+    int yMax = std::min(h - 1, ToPixel(ceilf(*std::max_element(y, y + n)), h));
+    if (xMin > xMax || yMin > yMax)
+        return;
+
+    // an edge function is smallest over a pixel at the corner half a pixel each way from its
+    // center, in whichever directions it gets smaller - so the edges are moved in by that much,
+    // and then a pixel whose center is inside them is inside the polygon all over
+    for (int k = 0; k < n; k++)
+        c[k] -= 0.5f * (fabsf(a[k]) + fabsf(b[k]));
+
+    // 1/z is linear in screen space, so is a plane too (through the first three vertices) -
+    // each pixel takes its value at the corner furthest from the camera (half a pixel each way,
+    // in whichever directions it gets smaller), but never less than at the furthest vertex
+    const float dx1 = x[1] - x[0], dy1 = y[1] - y[0], dw1 = iz[1] - iz[0];
+    const float dx2 = x[2] - x[0], dy2 = y[2] - y[0], dw2 = iz[2] - iz[0];
+    const float det = dx1 * dy2 - dx2 * dy1;
+    const float wa = (dw1 * dy2 - dw2 * dy1) / det;
+    const float wb = (dw2 * dx1 - dw1 * dx2) / det;
+    const float wc = iz[0] - wa * x[0] - wb * y[0];
+    const float wRound = 0.5f * (fabsf(wa) + fabsf(wb));
+    const float wFar = *std::min_element(iz, iz + n);
+    const float pxMax = static_cast<float>(xMax) + 0.5f;
+
+    for (int row = yMin; row <= yMax; row++)
+    {
+        const float py = static_cast<float>(row) + 0.5f;
+        const float r0 = b[0] * py + c[0];
+        const float r1 = b[1] * py + c[1];
+        const float r2 = b[2] * py + c[2];
+        const float r3 = b[3] * py + c[3];
+        const float rw = wb * py + wc;
+        float* pRow = &depth[static_cast<size_t>(row) * pitch];
+
+        int col = xMin;
+#if SIMD_AVX2
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 lanes = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+            // (the rows are padded, so the last vector of a row never runs past it)
+            for (; col <= xMax; col += 8)
+            {
+                __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(col)), lanes);
+                __m256 e0 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(a[0]), px), _mm256_set1_ps(r0));
+                __m256 e1 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(a[1]), px), _mm256_set1_ps(r1));
+                __m256 e2 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(a[2]), px), _mm256_set1_ps(r2));
+                __m256 e3 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(a[3]), px), _mm256_set1_ps(r3));
+                __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(e0, zero, _CMP_GE_OQ), _mm256_cmp_ps(e1, zero, _CMP_GE_OQ)),
+                                              _mm256_and_ps(_mm256_cmp_ps(e2, zero, _CMP_GE_OQ), _mm256_cmp_ps(e3, zero, _CMP_GE_OQ)));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(px, _mm256_set1_ps(pxMax), _CMP_LE_OQ));
+                __m256 wPix = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(wa), px), _mm256_set1_ps(rw));
+                wPix = _mm256_max_ps(_mm256_sub_ps(wPix, _mm256_set1_ps(wRound)), _mm256_set1_ps(wFar));
+                __m256 old = _mm256_loadu_ps(pRow + col);
+                _mm256_storeu_ps(pRow + col, _mm256_blendv_ps(old, _mm256_max_ps(old, wPix), inside));
+            }
+        }
+#elif SIMD_SSE2
+        {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 lanes = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            for (; col <= xMax; col += 4)
+            {
+                __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(col)), lanes);
+                __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[0]), px), _mm_set1_ps(r0));
+                __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[1]), px), _mm_set1_ps(r1));
+                __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[2]), px), _mm_set1_ps(r2));
+                __m128 e3 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[3]), px), _mm_set1_ps(r3));
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                           _mm_and_ps(_mm_cmpge_ps(e2, zero), _mm_cmpge_ps(e3, zero)));
+                inside = _mm_and_ps(inside, _mm_cmple_ps(px, _mm_set1_ps(pxMax)));
+                __m128 wPix = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(wa), px), _mm_set1_ps(rw));
+                wPix = _mm_max_ps(_mm_sub_ps(wPix, _mm_set1_ps(wRound)), _mm_set1_ps(wFar));
+                __m128 old = _mm_loadu_ps(pRow + col);
+                __m128 res = _mm_or_ps(_mm_and_ps(inside, _mm_max_ps(old, wPix)), _mm_andnot_ps(inside, old));
+                _mm_storeu_ps(pRow + col, res);
+            }
+        }
+#endif
+        for (; col <= xMax; col++)
+        {
+            float px = static_cast<float>(col) + 0.5f;
+            if (a[0] * px + r0 >= 0.0f && a[1] * px + r1 >= 0.0f && a[2] * px + r2 >= 0.0f && a[3] * px + r3 >= 0.0f)
+            {
+                float wPix = std::max(wa * px + rw - wRound, wFar);
+                pRow[col] = std::max(pRow[col], wPix);
+            }
+        }
+    }
+}
+
+// the box is projected, and its nearest point compared against every pixel its projection
+// touches - it's hidden only if there is something nearer at all of them
+// (occluders only cover the pixels they cover all of, so a pixel the box touches any part of
+// has something nearer everywhere in it)
+bool OcclusionBuffer::IsVisible(const BoundingBox& box, const Mat3& rotMat, const Vec3& transVec) const
+{
+    float xMinF = std::numeric_limits<float>::max(), xMaxF = std::numeric_limits<float>::lowest();
+    float yMinF = std::numeric_limits<float>::max(), yMaxF = std::numeric_limits<float>::lowest();
+    float zMin = std::numeric_limits<float>::max();
+    for (int i = 0; i < 8; i++)
+    {
+        Vec3 c = box.Corner(i) * rotMat + transVec;
+        if (c.z < NearZ)
+            return true;
+        xMinF = std::min(xMinF, ScreenX(c));
+        xMaxF = std::max(xMaxF, ScreenX(c));
+        yMinF = std::min(yMinF, ScreenY(c));
+        yMaxF = std::max(yMaxF, ScreenY(c));
+        zMin = std::min(zMin, c.z);
+    }
+    if (xMaxF < 0.0f || yMaxF < 0.0f || xMinF > static_cast<float>(w) || yMinF > static_cast<float>(h))
+        return false;
+
+    int xMin = std::max(0, ToPixel(floorf(xMinF), w));
+    int xMax = std::min(w - 1, ToPixel(floorf(xMaxF), w));
+    int yMin = std::max(0, ToPixel(floorf(yMinF), h));
+    int yMax = std::min(h - 1, ToPixel(floorf(yMaxF), h));
+    const float wNear = 1.0f / zMin;
+
+    for (int y = yMin; y <= yMax; y++)
+    {
+        const float* pRow = &depth[static_cast<size_t>(y) * pitch];
+        int x = xMin;
+#if SIMD_AVX2
+        {
+            const __m256 nearest = _mm256_set1_ps(wNear);
+            const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            for (; x <= xMax; x += 8)
+            {
+                __m256 showing = _mm256_cmp_ps(_mm256_loadu_ps(pRow + x), nearest, _CMP_LE_OQ);
+                __m256i inRow = _mm256_cmpgt_epi32(_mm256_set1_epi32(xMax + 1 - x), lanes);
+                if (_mm256_movemask_ps(_mm256_and_ps(showing, _mm256_castsi256_ps(inRow))))
+                    return true;
+            }
+        }
+#elif SIMD_SSE2
+        {
+            const __m128 nearest = _mm_set1_ps(wNear);
+            const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+            for (; x <= xMax; x += 4)
+            {
+                __m128 showing = _mm_cmple_ps(_mm_loadu_ps(pRow + x), nearest);
+                __m128i inRow = _mm_cmpgt_epi32(_mm_set1_epi32(xMax + 1 - x), lanes);
+                if (_mm_movemask_ps(_mm_and_ps(showing, _mm_castsi128_ps(inRow))))
+                    return true;
+            }
+        }
+#endif
+        for (; x <= xMax; x++)
+            if (pRow[x] <= wNear)
+                return true;
+    }
+
+    return false;
+}
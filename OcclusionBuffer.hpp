@@ -0,0 +1,81 @@
+//
+//  OcclusionBuffer.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef OcclusionBuffer_hpp
+#define OcclusionBuffer_hpp
+
+#include <vector>
+#include <algorithm>
+#include "Vec3.hpp"
+#include "Mat3.hpp"
+#include "Vec3Stream.hpp"
+#include "IndexedTriangleList.hpp"
+#include "MeshStreams.hpp"
+#include "BoundingBox.hpp"
+
+// a low resolution depth-only view of a few large occluders (e.g. walls), drawn before a frame,
+// against which the bounds of everything else can be tested - an object whose bounds are hidden
+// behind the occluders everywhere can be skipped before any of its vertices are shaded
+// each pixel holds the 1/z of the nearest occluder covering the whole of it (or 0, for nothing),
+// rounded towards the far side of the pixel, so that an object is only reported hidden if it
+// is behind an occluder everywhere it might show - a pixel only partly covered (e.g. along an
+// occluder's edge, or a crack between two occluders) is left open, even where two triangles
+// of the same occluder cover it between them
+// (the view is the same as Pipeline's - camera at the origin looking down +z, with x/z and y/z
+// from -1 to +1 across the screen - and as in Pipeline, nothing is clipped: occluder triangles
+// with a vertex behind NearZ are left out, and objects with a corner behind it are visible)
+class OcclusionBuffer
+{
+public:
+    static constexpr int DefaultWidth = 256;
+    static constexpr int DefaultHeight = 128;
+    static constexpr float NearZ = 0.01f;
+
+    OcclusionBuffer(int w = DefaultWidth, int h = DefaultHeight);
+    int Width() const { return w; }
+    int Height() const { return h; }
+    void Clear();
+    // draws a mesh's triangles (whichever way they face) as an occluder, rotated and then
+    // translated as a vertex shader would
+    // (the mesh's positions are taken from its streams, so any vertex type will do)
+    void AddOccluder(const MeshStreams& streams, const std::vector<IndexedTriangle>& triangles,
+                     const Mat3& rotMat, const Vec3& transVec);
+    // false if the box (in model space, rotated and then translated) is hidden behind the
+    // occluders drawn so far - or entirely off screen
+    bool IsVisible(const BoundingBox& box, const Mat3& rotMat, const Vec3& transVec) const;
+    // (the buffer's 1/z at a pixel, e.g. for debugging)
+    float GetDepth(int x, int y) const { return depth[y * pitch + x]; }
+    ~OcclusionBuffer() = default;
+
+private:
+    // (camera space to buffer coordinates)
+    float ScreenX(const Vec3& v) const { return (v.x / v.z + 1.0f) * halfW; }
+    float ScreenY(const Vec3& v) const { return (1.0f - v.y / v.z) * halfH; }
+    // (a buffer coordinate as a whole pixel, clamped in float to just past either edge first, so
+    // that it always fits in an int)
+    static int ToPixel(float c, int size) { return static_cast<int>(std::clamp(c, -1.0f, static_cast<float>(size))); }
+    bool FormQuad(const IndexedTriangle& t1, const IndexedTriangle& t2, Vec3* pQuad) const;
+    // (a triangle or a quad - it must be convex, and flat)
+    void DrawConvex(const Vec3* v, int n);
+    // (how far out of plane, relative to its size, a quad can be)
+    static constexpr float PlanarTolerance = 1e-4f;
+
+    int w;
+    int h;
+    // (rows are padded by most of an AVX2 vector, and out to a whole number of them, so that a
+    // vector starting at any pixel of a row never runs past the end of it)
+    int pitch;
+    float halfW;
+    float halfH;
+    std::vector<float> depth;
+    // (the occluder being drawn, in camera space - kept between occluders, so that its memory is
+    // reused)
+    Vec3Stream positions;
+};
+
+#endif /* OcclusionBuffer_hpp */
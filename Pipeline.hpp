@@ -10,37 +10,98 @@
 #define Pipeline_hpp
 
 #include <vector>
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 #include "Color.hpp"
+#include "ColorOps.hpp"
 #include "Surface.hpp"
 #include "Vec2.hpp"
 #include "Mat3.hpp"
+#include "MeshStreams.hpp"
 #include "Graphics.hpp"
 #include "ScreenTransform.hpp"
 #include "IndexedLineList.hpp"
 #include "IndexedTriangleList.hpp"
 #include "Utils.hpp"
 #include "Triangle.hpp"
+#include "EffectTraits.hpp"
+#include "Interpolants.hpp"
 
-template <typename Effect>
+// draws into the screen by default, or into any other target with the same drawing interface
+// (e.g. a RenderTarget)
+template <typename Effect, typename Target = Graphics>
 class Pipeline
 {
     using Vertex = typename Effect::Vertex;
     using VertexShader = typename Effect::VertexShader;
+    using GeometryShader = typename Effect::GeometryShader;
     using VSOutVertex = typename Effect::VertexShader::OutVertex;
     using GSOutVertex = typename Effect::GeometryShader::OutVertex;
     using PixelShader = typename Effect::PixelShader;
     
 public:
-    Pipeline(Graphics& g):
-        g(g)
+    // (any further arguments are passed on to the effect's constructor)
+    template <typename... EffectArgs>
+    Pipeline(Target& g, EffectArgs&&... effectArgs):
+        g(g),
+        st(g.GetScreenWidth(), g.GetScreenHeight()),
+        effect(std::forward<EffectArgs>(effectArgs)...)
     {}
+    // attributes are perspective corrected exactly for every pixel by default - with a span of
+    // more than 1, they are only corrected every that many pixels, and interpolated linearly in
+    // between (8 or 16 is hard to tell apart from exact, at the resolutions drawn at)
+    void SetPerspectiveSpan(int pixels) { perspectiveSpan = std::max(pixels, 1); }
     void Draw(const IndexedTriangleList<Vertex>& itl)
     {
-        // run the vertex shader over all vertices
-        std::vector<VSOutVertex> transformedVertices;
-        for (const auto& v : itl.vertices)
-            transformedVertices.push_back(effect.vertexShader(v));
-        
+        if constexpr (UsesBatches<VertexShader>::value)
+        {
+            // (gathered on every draw - a mesh drawn more than once should keep its own streams,
+            // see below)
+            streams.Assign(itl.vertices);
+            Draw(itl, streams);
+        }
+        else
+        {
+            BeginDraw();
+            
+            // run the vertex shader over all vertices
+            transformedVertices.clear();
+            for (const auto& v : itl.vertices)
+                transformedVertices.push_back(effect.vertexShader(v));
+            
+            DrawTriangles(itl);
+        }
+    }
+    // (the same, with the mesh's vertices already gathered into streams - which a batched vertex
+    // shader transforms directly, and any other vertex shader ignores)
+    void Draw(const IndexedTriangleList<Vertex>& itl, const MeshStreams& meshStreams)
+    {
+        if constexpr (UsesBatches<VertexShader>::value)
+        {
+            assert(meshStreams.Size() == itl.vertices.size());
+            BeginDraw();
+            effect.vertexShader(itl.vertices.size(), meshStreams.positions, meshStreams.normals, transformedVertices);
+            DrawTriangles(itl);
+        }
+        else
+        {
+            Draw(itl);
+        }
+    }
+    
+private:
+    void BeginDraw()
+    {
+        // pick up the current render resolution, which may differ from the last draw
+        st = ScreenTransform(g.GetScreenWidth(), g.GetScreenHeight());
+        span.resize(g.GetScreenWidth());
+        if constexpr (UsesSpans<PixelShader>::value)
+            spanAttributes.Resize(g.GetScreenWidth());
+    }
+    void DrawTriangles(const IndexedTriangleList<Vertex>& itl)
+    {
         // determine which triangles should be culled
         for (const auto& t : itl.triangles)
         {
@@ -58,16 +119,19 @@ public:
                 ProcessTriangle(v1, v2, v3);
         }
     }
-    
-private:
     void ProcessTriangle(const VSOutVertex& v1, const VSOutVertex& v2, const VSOutVertex& v3)
     {
-        Triangle<GSOutVertex> t = effect.geometryShader({v1, v2, v3});
+        Triangle<GSOutVertex> t;
+        if constexpr (IsPassThrough<GeometryShader>::value)
+            t = {v1, v2, v3};
+        else
+            t = effect.geometryShader({v1, v2, v3});
         
         // translate everything into screen space
-        ScreenTransform::Transform(t.v1);
-        ScreenTransform::Transform(t.v2);
-        ScreenTransform::Transform(t.v3);
+        constexpr bool perspectiveCorrect = NeedsPerspectiveCorrection<PixelShader>::value;
+        st.Transform<perspectiveCorrect>(t.v1);
+        st.Transform<perspectiveCorrect>(t.v2);
+        st.Transform<perspectiveCorrect>(t.v3);
 
         DrawTriangle(t.v1, t.v2, t.v3);
     }
@@ -118,6 +182,11 @@ private:
     }
     void DrawTriangle(const GSOutVertex& v1, const GSOutVertex& v2, const GSOutVertex& v3)
     {
+        if constexpr (UsesFlatAttributes<PixelShader>::value)
+            flatColor = effect.pixelShader(v1);
+        else if constexpr (UsesDerivatives<PixelShader>::value)
+            CalcDerivatives(v1, v2, v3);
+        
         // rearrange vertices such that v1 is at the top and v3 is at the bottom
         const GSOutVertex* pV1 = &v1;
         const GSOutVertex* pV2 = &v2;
@@ -162,6 +231,26 @@ private:
             }
         }
     }
+    // calculates how all (screen-space, i.e. divided by z) attributes change per pixel step in the
+    // x and y directions - these are constant over the whole triangle, since the attributes are
+    // linear in screen space
+    void CalcDerivatives(const GSOutVertex& v1, const GSOutVertex& v2, const GSOutVertex& v3)
+    {
+        float dx2 = v2.v.x - v1.v.x;
+        float dy2 = v2.v.y - v1.v.y;
+        float dx3 = v3.v.x - v1.v.x;
+        float dy3 = v3.v.y - v1.v.y;
+        
+        // (twice the signed area of the triangle - a degenerate triangle won't cover any pixels)
+        float det = dx2 * dy3 - dx3 * dy2;
+        if (det == 0.0f)
+            return;
+        
+        GSOutVertex d2 = v2 - v1;
+        GSOutVertex d3 = v3 - v1;
+        dVdx = (d2 * dy3 - d3 * dy2) / det;
+        dVdy = (d3 * dx2 - d2 * dx3) / det;
+    }
     //   v1 *-------* v2
     //       \     /
     //        \   /
@@ -199,8 +288,11 @@ private:
     {
         // quantize the beginning (inclusive) and end (non-inclusive) y values for the top and bottom of
         // the triangle, following our rasterization rules
-        int yStart = Rast(v1.v.y);
-        int yEnd = Rast(v3.v.y);
+        // (clamped to the screen, for triangles that are partly off it - rows and columns are
+        // still stepped to from the triangle's own edges, so nothing else changes)
+        int yStart = std::max(Rast(v1.v.y), 0);
+        int yEnd = std::min(Rast(v3.v.y), g.GetScreenHeight());
+        const int screenWidth = g.GetScreenWidth();
         
         // *rough* initial values for starting/ending x, but...
         GSOutVertex xStartVertex = v1; // (same for either flat top triangle or flat bottom triangle)
@@ -213,29 +305,71 @@ private:
         xStartVertex += stepPerYLeft * yOffsetForFirstRow;
         xEndVertex += stepPerYRight * yOffsetForFirstRow;
         
-        GSOutVertex currPixelVertex;
-        GSOutVertex stepPerX;
-        
         for (int y = yStart; y < yEnd; y++)
         {
             // quantize the beginning (inclusive) and end (non-inclusive) x values for the left and right of
             // the triangle, following our rasterization rules
-            int xStartI = Rast(xStartVertex.v.x);
-            int xEndI = Rast(xEndVertex.v.x);
+            int xStartI = std::max(Rast(xStartVertex.v.x), 0);
+            int xEndI = std::min(Rast(xEndVertex.v.x), screenWidth);
             
-            // interpolate all aspects of a Vertex as we scan in the x direction
-            // (we know that that the calculated "x step per x" will of course be 1.0f, and the "y step per x" will
-            // of course be 0.0f - we don't really need to do this math, but that's ok - it simplifies the code)
-            stepPerX = (xEndVertex - xStartVertex) / (xEndVertex.v.x - xStartVertex.v.x);
-            
-            // *rough* initial values for starting x, but...
-            currPixelVertex = xStartVertex;
-            
-            // similar to above, we will "bump" the texture starting coordinates a bit based on
-            // the horizontal center of the first column
-            currPixelVertex += stepPerX * (static_cast<float>(xStartI) + 0.5f - xStartVertex.v.x);
+            // (with flat attributes, every pixel is the same color - so the row is filled straight
+            // into the target, without going through the span buffer)
+            if constexpr (UsesFlatAttributes<PixelShader>::value)
+            {
+                g.FillSpan(y, xStartI, xEndI, flatColor);
+            }
+            else
+            {
+                if (NeedsPerspectiveCorrection<PixelShader>::value && perspectiveSpan > 1)
+                    ShadeSpanSubdivided(xStartVertex, xEndVertex, xStartI, xEndI);
+                else
+                    ShadeSpan(xStartVertex, xEndVertex, xStartI, xEndI);
+                g.WriteSpan(y, xStartI, xEndI, span.data());
+            }
             
-            for (int x = xStartI; x < xEndI; x++)
+            xStartVertex += stepPerYLeft;
+            xEndVertex += stepPerYRight;
+        }
+    }
+    // shades a row of pixels into the span buffer, interpolating all aspects of a vertex across it
+    void ShadeSpan(const GSOutVertex& xStartVertex, const GSOutVertex& xEndVertex, int xStartI, int xEndI)
+    {
+        // interpolate all aspects of a Vertex as we scan in the x direction
+        // (we know that that the calculated "x step per x" will of course be 1.0f, and the "y step per x" will
+        // of course be 0.0f - we don't really need to do this math, but that's ok - it simplifies the code)
+        GSOutVertex stepPerX = (xEndVertex - xStartVertex) / (xEndVertex.v.x - xStartVertex.v.x);
+        
+        // *rough* initial values for starting x, but...
+        GSOutVertex currPixelVertex = xStartVertex;
+        
+        // similar to above, we will "bump" the texture starting coordinates a bit based on
+        // the horizontal center of the first column
+        currPixelVertex += stepPerX * (static_cast<float>(xStartI) + 0.5f - xStartVertex.v.x);
+        
+        // (a span pixel shader is given the derivatives at either end of each stretch - without
+        // perspective correction they're the same all along the row, so the row is one stretch,
+        // and with it they're worked out for every pixel, so every pixel is its own stretch)
+        constexpr bool gatherStretches = UsesSpans<PixelShader>::value && UsesDerivatives<PixelShader>::value;
+        if constexpr (gatherStretches && !NeedsPerspectiveCorrection<PixelShader>::value)
+        {
+            if (xEndI > xStartI)
+            {
+                SpanStretch<GSOutVertex> s{ 0, xEndI - xStartI, xEndI - xStartI - 1 };
+                CalcPixelDerivatives(currPixelVertex, 1.0f, s.ddxStart, s.ddyStart);
+                s.ddxEnd = s.ddxStart;
+                s.ddyEnd = s.ddyStart;
+                spanStretches.push_back(s);
+            }
+        }
+        
+        for (int x = xStartI; x < xEndI; x++)
+        {
+            if constexpr (!NeedsPerspectiveCorrection<PixelShader>::value)
+            {
+                // (attributes were never divided by z, so there is nothing to recover)
+                ShadePixel(x - xStartI, currPixelVertex, 1.0f);
+            }
+            else
             {
                 // remember that the z member was "hacked" to actually represent 1/z during the object
                 // space to screen space transformation (ScreenTransform class)!
@@ -243,18 +377,188 @@ private:
                 
                 // recover attributes of the vertex which had previously been transformed by the screen-space
                 // transformation
-                GSOutVertex currPixelVertexRecovered = currPixelVertex / zInv;
-                g.PutPixel(x, y, effect.pixelShader(currPixelVertexRecovered));
+                GSOutVertex recovered = currPixelVertex / zInv;
+                if constexpr (gatherStretches)
+                {
+                    SpanStretch<GSOutVertex> s{ x - xStartI, 1, 0 };
+                    CalcPixelDerivatives(recovered, zInv, s.ddxStart, s.ddyStart);
+                    s.ddxEnd = s.ddxStart;
+                    s.ddyEnd = s.ddyStart;
+                    spanStretches.push_back(s);
+                }
+                ShadePixel(x - xStartI, recovered, zInv);
+            }
+            
+            currPixelVertex += stepPerX;
+        }
+        
+        if constexpr (UsesSpans<PixelShader>::value)
+            ShadeGatheredSpan(xEndI - xStartI);
+    }
+    // the same as ShadeSpan, but attributes are only recovered exactly at either end of each
+    // stretch of perspectiveSpan pixels, and interpolated linearly (i.e. without a divide per
+    // pixel) in between - where depth hardly changes along the row, the whole row is one stretch,
+    // and where it changes quickly (e.g. a face seen nearly edge on), stretches are made shorter
+    void ShadeSpanSubdivided(const GSOutVertex& xStartVertex, const GSOutVertex& xEndVertex, int xStartI, int xEndI)
+    {
+        GSOutVertex stepPerX = (xEndVertex - xStartVertex) / (xEndVertex.v.x - xStartVertex.v.x);
+        GSOutVertex currPixelVertex = xStartVertex;
+        currPixelVertex += stepPerX * (static_cast<float>(xStartI) + 0.5f - xStartVertex.v.x);
+        
+        int stretch = perspectiveSpan;
+        float zInvStart = currPixelVertex.v.z;
+        float zInvEnd = zInvStart + stepPerX.v.z * static_cast<float>(xEndI - xStartI);
+        if (fabs(zInvEnd - zInvStart) <= AffineDepthTolerance * std::min(zInvStart, zInvEnd))
+            stretch = xEndI - xStartI;
+        
+        GSOutVertex recovered = currPixelVertex / currPixelVertex.v.z;
+        
+        // (a span pixel shader is given the derivatives at either end of each stretch - where each
+        // stretch's end is the next one's start)
+        GSOutVertex ddxStart, ddyStart;
+        if constexpr (UsesSpans<PixelShader>::value && UsesDerivatives<PixelShader>::value)
+            CalcPixelDerivatives(recovered, currPixelVertex.v.z, ddxStart, ddyStart);
+        
+        for (int x = xStartI; x < xEndI; )
+        {
+            // (halved until 1/z changes by no more than MaxStretchDepthChange of itself along it -
+            // the linear interpolation is furthest off where 1/z is smallest, so the stretch is
+            // measured against whichever end that is)
+            int n = std::min(stretch, xEndI - x);
+            const float zInvChange = fabs(stepPerX.v.z);
+            while (n > 1 && zInvChange * static_cast<float>(n) >
+                   MaxStretchDepthChange * std::min(currPixelVertex.v.z, currPixelVertex.v.z + stepPerX.v.z * static_cast<float>(n)))
+                n /= 2;
+            
+            // (the last stretch ends on the last pixel, rather than the one after it - which would be
+            // outside the triangle, where attributes may be out of range)
+            int steps = (x + n == xEndI) ? n - 1 : n;
+            GSOutVertex stretchEndVertex = currPixelVertex + stepPerX * static_cast<float>(steps);
+            GSOutVertex stretchEndRecovered = stretchEndVertex / stretchEndVertex.v.z;
+            GSOutVertex recoveredStep = (steps > 0) ? (stretchEndRecovered - recovered) / static_cast<float>(steps) :
+                stretchEndRecovered - recovered;
+            
+            if constexpr (HasColorAttributes<PixelShader>::value)
+            {
+                RampColors(x - xStartI, recovered, recoveredStep, n);
+                x += n;
+            }
+            else
+            {
+                if constexpr (UsesSpans<PixelShader>::value && UsesDerivatives<PixelShader>::value)
+                {
+                    SpanStretch<GSOutVertex> s{ x - xStartI, n, steps, ddxStart, ddyStart };
+                    CalcPixelDerivatives(stretchEndRecovered, stretchEndVertex.v.z, s.ddxEnd, s.ddyEnd);
+                    spanStretches.push_back(s);
+                    ddxStart = s.ddxEnd;
+                    ddyStart = s.ddyEnd;
+                }
                 
-                currPixelVertex += stepPerX;
+                // (1/z itself is linear in screen space, so it's always exact)
+                float zInv = currPixelVertex.v.z;
+                for (int i = 0; i < n; i++, x++)
+                {
+                    ShadePixel(x - xStartI, recovered, zInv);
+                    recovered += recoveredStep;
+                    zInv += stepPerX.v.z;
+                }
             }
             
-            xStartVertex += stepPerYLeft;
-            xEndVertex += stepPerYRight;
+            currPixelVertex = stretchEndVertex;
+            recovered = stretchEndRecovered;
         }
+        
+        if constexpr (UsesSpans<PixelShader>::value && !HasColorAttributes<PixelShader>::value)
+            ShadeGatheredSpan(xEndI - xStartI);
+    }
+    // fills n pixels of the span buffer, from pixel i on, with the pixel shader's color attributes
+    // stepped linearly from the given vertex
+    void RampColors(int i, const GSOutVertex& start, const GSOutVertex& step, int n)
+    {
+        constexpr size_t c = PixelShader::ColorAttribute;
+        ColorOps::Ramp(start.attr.GetVec3(c), step.attr.GetVec3(c), span.data() + i, n);
     }
+    // shades one pixel of the span buffer, given its recovered attributes (and 1/z, for working out
+    // derivatives) - or, for span pixel shaders, just gathers its attributes for ShadeGatheredSpan
+    void ShadePixel(int i, const GSOutVertex& recovered, float zInv)
+    {
+        if constexpr (UsesSpans<PixelShader>::value)
+        {
+            spanAttributes.Set(i, recovered.attr);
+            if (i == 0)
+                spanFirst = recovered;
+        }
+        else if constexpr (UsesDerivatives<PixelShader>::value)
+        {
+            GSOutVertex ddx, ddy;
+            CalcPixelDerivatives(recovered, zInv, ddx, ddy);
+            span[i] = effect.pixelShader(recovered, ddx, ddy);
+        }
+        else
+        {
+            span[i] = effect.pixelShader(recovered);
+        }
+    }
+    void CalcPixelDerivatives(const GSOutVertex& recovered, float zInv, GSOutVertex& ddx, GSOutVertex& ddy) const
+    {
+        if constexpr (!NeedsPerspectiveCorrection<PixelShader>::value)
+        {
+            // (attributes are linear in screen space, so their derivatives are the triangle's)
+            ddx = dVdx;
+            ddy = dVdy;
+        }
+        else
+        {
+            // the derivatives of a recovered attribute a = (a/z)/(1/z) follow from the quotient rule
+            ddx = (dVdx - recovered * dVdx.v.z) / zInv;
+            ddy = (dVdy - recovered * dVdy.v.z) / zInv;
+        }
+    }
+    // shades the n pixels gathered by ShadePixel in one call to a span pixel shader, which writes
+    // straight into the span buffer
+    // (along with the derivatives at either end of each stretch of the row, if it uses them)
+    void ShadeGatheredSpan(int n)
+    {
+        if (n > 0)
+        {
+            if constexpr (UsesDerivatives<PixelShader>::value)
+                effect.pixelShader(spanAttributes, spanFirst, spanStretches, span.data(), n);
+            else
+                effect.pixelShader(spanAttributes, spanFirst, span.data(), n);
+        }
+        spanStretches.clear();
+    }
+    
+    Target& g;
+    ScreenTransform st;
+    
+    // screen-space derivatives of the triangle currently being drawn (only calculated if the
+    // pixel shader uses them)
+    GSOutVertex dVdx;
+    GSOutVertex dVdy;
+    
+    // the colors of the row of pixels currently being drawn
+    std::vector<unsigned int> span;
+    
+    // (only used by span pixel shaders - the row's attributes, its first pixel, and the derivatives
+    // at either end of each of its stretches)
+    typename UsesSpans<PixelShader>::Span spanAttributes;
+    GSOutVertex spanFirst;
+    std::vector<SpanStretch<GSOutVertex>> spanStretches;
+    
+    // (only used by pixel shaders with flat attributes)
+    Color flatColor = Colors::Black;
+    
+    int perspectiveSpan = 1;
+    // (rows where 1/z changes by less than this fraction are interpolated linearly in one go)
+    static constexpr float AffineDepthTolerance = 1.0f / 256.0f;
+    // (and no stretch is long enough for 1/z to change by more than this fraction along it)
+    static constexpr float MaxStretchDepthChange = 1.0f / 16.0f;
     
-    Graphics& g;
+    // (kept between draws, so that their memory is reused)
+    std::vector<VSOutVertex> transformedVertices;
+    // (only used by batched vertex shaders, for meshes drawn without streams of their own)
+    MeshStreams streams;
     
 public:
     Effect effect;
@@ -0,0 +1,84 @@
+//
+//  PixelFormat.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef PixelFormat_hpp
+#define PixelFormat_hpp
+
+#include <cstdint>
+#include "Color.hpp"
+#include "ColorOps.hpp"
+
+// the formats surfaces can store their pixels in - each format gives the type of a pixel, and
+// converts pixels to and from colors
+namespace PixelFormats
+{
+    // 8 bits per channel, packed into 32 bits (the same as Color)
+    struct ARGB8888
+    {
+        typedef unsigned int Pixel;
+
+        static constexpr Pixel FromColor(const Color& c) { return c; }
+        static constexpr Color ToColor(Pixel p) { return p; }
+        static constexpr Pixel Add(Pixel a, Pixel b) { return ColorOps::Add(a, b); }
+    };
+
+    // 5 bits of red, 6 of green and 5 of blue, in 16 bits - half the memory and bandwidth of
+    // ARGB8888, at the cost of some banding
+    struct RGB565
+    {
+        typedef uint16_t Pixel;
+
+        static constexpr Pixel FromColor(const Color& c)
+        {
+            return static_cast<Pixel>((c.R() >> 3) << 11 | (c.G() >> 2) << 5 | (c.B() >> 3));
+        }
+        // (the top bits of each channel are repeated in the bits below them, so that full
+        // intensity maps back to 255)
+        static constexpr Color ToColor(Pixel p)
+        {
+            return Color(static_cast<unsigned char>((p >> 11) << 3 | (p >> 13)),
+                         static_cast<unsigned char>(((p >> 5) & 0x3F) << 2 | ((p >> 9) & 0x03)),
+                         static_cast<unsigned char>((p & 0x1F) << 3 | ((p >> 2) & 0x07)));
+        }
+        static constexpr Pixel Add(Pixel a, Pixel b)
+        {
+            return FromColor(ColorOps::Add(ToColor(a), ToColor(b)));
+        }
+    };
+
+    // a float per channel, where 1.0 is full intensity - values aren't clamped, so this can hold
+    // e.g. the sum of several passes
+    struct RGBAFloat
+    {
+        struct Pixel
+        {
+            float r, g, b, a;
+        };
+
+        static constexpr Pixel FromColor(const Color& c)
+        {
+            return { c.R() / 255.0f, c.G() / 255.0f, c.B() / 255.0f, 0.0f };
+        }
+        static constexpr Color ToColor(const Pixel& p)
+        {
+            return Color(ToChannel(p.r), ToChannel(p.g), ToChannel(p.b));
+        }
+        static constexpr Pixel Add(const Pixel& a, const Pixel& b)
+        {
+            return { a.r + b.r, a.g + b.g, a.b + b.b, a.a + b.a };
+        }
+
+    private:
+        static constexpr unsigned char ToChannel(float f)
+        {
+            return (f <= 0.0f) ? 0 : (f >= 1.0f) ? 255 : static_cast<unsigned char>(f * 255.0f + 0.5f);
+        }
+    };
+}
+
+#endif /* PixelFormat_hpp */
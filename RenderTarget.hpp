@@ -0,0 +1,66 @@
+//
+//  RenderTarget.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef RenderTarget_hpp
+#define RenderTarget_hpp
+
+#include "Surface.hpp"
+#include "Color.hpp"
+
+// an off-screen surface for a pipeline to draw into, in any pixel format (the screen itself is
+// drawn into through Graphics) - e.g. a float target, with blending set to add, to accumulate
+// several passes before converting the result for display
+template <typename Format>
+class RenderTarget
+{
+public:
+    enum class Blend
+    {
+        Replace,    // pixels overwrite what was there
+        Add         // pixels are added to what was there
+    };
+    
+    RenderTarget(int w, int h):
+        surface(w, h)
+    {}
+    // (named to match Graphics, so that pipelines can draw into either)
+    int GetScreenWidth() const { return surface.Width(); }
+    int GetScreenHeight() const { return surface.Height(); }
+    void PutPixel(int x, int y, const Color& c)
+    {
+        if (blend == Blend::Add)
+            surface.AddPixel(x, y, c);
+        else
+            surface.PutPixel(x, y, c);
+    }
+    void WriteSpan(int y, int x0, int x1, const unsigned int* pColors)
+    {
+        if (blend == Blend::Add)
+            for (int x = x0; x < x1; x++)
+                surface.AddPixel(x, y, pColors[x - x0]);
+        else
+            surface.WriteSpan(y, x0, x1, pColors);
+    }
+    void FillSpan(int y, int x0, int x1, const Color& c)
+    {
+        if (blend == Blend::Add)
+            for (int x = x0; x < x1; x++)
+                surface.AddPixel(x, y, c);
+        else
+            surface.FillSpan(y, x0, x1, c);
+    }
+    void SetBlend(Blend b) { blend = b; }
+    void Clear(const Color& c) { surface.Fill(c); }
+    const BasicSurface<Format>& GetSurface() const { return surface; }
+    
+private:
+    BasicSurface<Format> surface;
+    Blend blend = Blend::Replace;
+};
+
+#endif /* RenderTarget_hpp */
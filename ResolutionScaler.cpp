@@ -0,0 +1,54 @@
+//
+//  ResolutionScaler.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <cmath>
+#include "ResolutionScaler.hpp"
+#include "Utils.hpp"
+
+ResolutionScaler::ResolutionScaler(float targetFrameTimeSecs, float minScale, float maxScale):
+    targetFrameTimeSecs(targetFrameTimeSecs),
+    minScale(minScale),
+    maxScale(maxScale),
+    scale(maxScale),
+    smoothedFrameTimeSecs(targetFrameTimeSecs)
+{
+}
+
+float ResolutionScaler::Update(float frameTimeSecs)
+{
+    smoothedFrameTimeSecs += (frameTimeSecs - smoothedFrameTimeSecs) * SmoothingFactor;
+    
+    if (framesUntilChange > 0)
+    {
+        framesUntilChange--;
+        return scale;
+    }
+    
+    float newScale = scale;
+    if (smoothedFrameTimeSecs > targetFrameTimeSecs)
+    {
+        // jump straight to the scale that should hit the budget, assuming that frame time is
+        // proportional to the pixel count
+        newScale = scale * sqrt(targetFrameTimeSecs / smoothedFrameTimeSecs);
+    }
+    else if (smoothedFrameTimeSecs < targetFrameTimeSecs * Headroom)
+    {
+        newScale = scale + IncreaseStep;
+    }
+    
+    Utils::Clamp(newScale, minScale, maxScale);
+    if (newScale != scale)
+    {
+        // assume that the new scale will land right around the budget until measured otherwise
+        smoothedFrameTimeSecs = smoothedFrameTimeSecs * (newScale * newScale) / (scale * scale);
+        scale = newScale;
+        framesUntilChange = CooldownFrames;
+    }
+    
+    return scale;
+}
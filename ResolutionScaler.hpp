@@ -0,0 +1,49 @@
+//
+//  ResolutionScaler.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef ResolutionScaler_hpp
+#define ResolutionScaler_hpp
+
+#include "Graphics.hpp"
+
+// picks a render scale (fraction of the window resolution) that keeps the frame time
+// under a target budget
+// rendering cost is roughly proportional to the number of pixels, i.e. to the square
+// of the scale - the scale is dropped quickly when over budget, and raised slowly (and
+// only when comfortably under budget) in order to avoid oscillating between resolutions
+class ResolutionScaler
+{
+public:
+    ResolutionScaler(float targetFrameTimeSecs = DefaultTargetFrameTimeSecs,
+                     float minScale = Graphics::MinRenderScale,
+                     float maxScale = 1.0f);
+    ~ResolutionScaler() = default;
+    float Update(float frameTimeSecs);
+    float GetScale() const { return scale; }
+
+    static constexpr float DefaultTargetFrameTimeSecs = 1.0f / 60.0f;
+
+private:
+    // weight given to the newest frame time when smoothing
+    static constexpr float SmoothingFactor = 0.1f;
+    // fraction of the budget that frame time must be under before the scale is raised
+    static constexpr float Headroom = 0.8f;
+    static constexpr float IncreaseStep = 0.05f;
+    // number of frames to wait after a change before changing again, so that the effect of
+    // the last change can show up in the measured frame times
+    static constexpr int CooldownFrames = 15;
+
+    const float targetFrameTimeSecs;
+    const float minScale;
+    const float maxScale;
+    float scale;
+    float smoothedFrameTimeSecs;
+    int framesUntilChange = CooldownFrames;
+};
+
+#endif /* ResolutionScaler_hpp */
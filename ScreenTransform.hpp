@@ -9,15 +9,26 @@
 #ifndef ScreenTransform_hpp
 #define ScreenTransform_hpp
 
-#include "Graphics.hpp"
 #include "Vec3.hpp"
+#include "Vec4.hpp"
+#include "Mat4.hpp"
 
 // this class transforms objects in a coordinate system where the screen width and height
 // range from -1 to +1 to the actual screen dimensions in terms of pixels
+// (the screen dimensions are only known at runtime, as the render resolution may change
+// from frame to frame)
 class ScreenTransform
 {
 public:
-    ScreenTransform() = delete;
+    ScreenTransform(int screenWidth, int screenHeight)
+    {
+        // scale x and y from -1..+1 to half the screen dimensions (flipping y, as screen y goes
+        // down), then move the origin to the center of the screen
+        float halfScreenWidth = static_cast<float>(screenWidth) / 2.0f;
+        float halfScreenHeight = static_cast<float>(screenHeight) / 2.0f;
+        viewport = Mat4::Translation(Vec3(halfScreenWidth, halfScreenHeight, 0.0f)) *
+            Mat4::Scaling(halfScreenWidth, -halfScreenHeight, 1.0f);
+    }
     
     // this function takes a Vertex in object space (x, y, z, other attributes) and translates it
     // into screen space, with an output as follows:
@@ -25,27 +36,32 @@ public:
     // - z is "hacked" to actually hold 1/z!
     // - all other attributes hold (their original value)/z - values divided by z can be linearly
     //   interpolated while moving across screen space, e.g. for perspective-correct texture mapping
-    template <typename Vertex>
-    static void Transform(Vertex& v)
+    //   (unless perspectiveCorrect is false, in which case they are left as they are, to be
+    //   interpolated linearly in screen space)
+    template <bool perspectiveCorrect = true, typename Vertex>
+    void Transform(Vertex& v) const
     {
         auto zInv = 1.0f/v.v.z;
         
         // divide all attributes by z
-        v *= zInv;
+        if constexpr (perspectiveCorrect)
+            v *= zInv;
+        else
+            v.v *= zInv;
         
         // translate x and y from object space to screen space
-        v.v.x = (v.v.x + 1.0f) * HalfScreenWidth;
-        v.v.y = (-v.v.y + 1.0f) * HalfScreenHeight;
+        Vec4 screenPos = Vec4(v.v, 1.0f) * viewport;
+        v.v.x = screenPos.x;
+        v.v.y = screenPos.y;
         
         // "hack" the z member to actually hold 1/z - this will be used later when rendering
         // to recover attributes, such as texture u/v coordinates
         v.v.z = zInv;
     }
-    ~ScreenTransform() = delete;
+    ~ScreenTransform() = default;
     
-public:
-    static constexpr float HalfScreenHeight = static_cast<float>(Graphics::ScreenHeight) / 2.0f;
-    static constexpr float HalfScreenWidth = static_cast<float>(Graphics::ScreenWidth) / 2.0f;
+private:
+    Mat4 viewport;
 };
 
 #endif /* ScreenTransform_hpp */
@@ -0,0 +1,26 @@
+//
+//  Simd.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef Simd_hpp
+#define Simd_hpp
+
+// works out which SIMD instruction sets can be used, based on the compiler's target settings
+// (SSE2 is always available on x64, and on x86 when MSVC's /arch:SSE2 or higher is used) - code
+// using these should always have a plain C++ fallback, e.g. for ARM
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+#endif /* Simd_hpp */
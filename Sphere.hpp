@@ -15,6 +15,10 @@
 #include "Vec3.hpp"
 #include "IndexedLineList.hpp"
 #include "IndexedTriangleList.hpp"
+#include "MeshLod.hpp"
+#include "MeshSimplifier.hpp"
+#include "BoundingBox.hpp"
+#include "BoundingSphere.hpp"
 #include "FlatShadingEffect.hpp"
 #include "GouraudEffect.hpp"
 #include "Utils.hpp"
@@ -120,6 +124,9 @@ public:
         AddVertex(0.0f, -radius, 0.0f); // south pole
         
         assert(normals.size() == vertices.size());
+        
+        boundingBox = BoundingBox::FromPoints(vertices);
+        boundingSphere = BoundingSphere::FromPoints(vertices);
     }
     IndexedTriangleList<Vec3> GetIndexedTriangleList()
     {
@@ -141,8 +148,28 @@ public:
         
         return { verticesG, triangles };
     }
+    // (around the model space vertices, worked out once when the mesh is built)
+    const BoundingBox& GetBoundingBox() const { return boundingBox; }
+    const BoundingSphere& GetBoundingSphere() const { return boundingSphere; }
+    // the sphere at several levels of detail, from enough to fill the screen down to a handful
+    // of triangles (see MeshLod) - each simplified from the most detailed (see MeshSimplifier)
+    static MeshLod<FlatShadingEffect::Vertex> GetLodFS(float radius = 1.0f)
+    {
+        return MeshSimplifier::BuildLod(Sphere(radius, LodVertices).GetIndexedTriangleListFS(), LodTargets);
+    }
+    static MeshLod<GouraudEffect::Vertex> GetLodG(float radius = 1.0f)
+    {
+        return MeshSimplifier::BuildLod(Sphere(radius, LodVertices).GetIndexedTriangleListG(), LodTargets);
+    }
     
 private:
+    // (the number of vertices from pole to pole of the most detailed level, and the fraction of
+    // its triangles each level keeps - about as many as a sphere of 16, 8 and 4 vertices has -
+    // with the smallest screen size each is drawn at)
+    static constexpr int LodVertices = 32;
+    static inline const std::vector<MeshSimplifier::LodTarget> LodTargets =
+        { { 1.0f, 600.0f }, { 0.25f, 200.0f }, { 0.06f, 60.0f }, { 0.012f, 0.0f } };
+
     void AddVertex(float x, float y, float z)
     {
         Vec3 v(x, y, z);
@@ -156,6 +183,8 @@ private:
     std::vector<Vec3> vertices;
     std::vector<Vec3> normals;
     std::vector<IndexedTriangle> triangles;
+    BoundingBox boundingBox;
+    BoundingSphere boundingSphere;
 };
 
 #endif /* Sphere_hpp */
@@ -7,32 +7,58 @@
 //
 
 #include <cassert>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include "Surface.hpp"
+#include "Simd.hpp"
 #include "Color.hpp"
 #include "Utils.hpp"
 
-void Surface::FillXorPattern()
+template <typename Format>
+void BasicSurface<Format>::FillXorPattern()
 {
-    int offset = 0;
-    for (int x = 0; x < w; x++)
+    for (int y = 0; y < h; y++)
     {
-        for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
         {
-            pPixelBuffer[offset++] = Color(x ^ y, (h - 1) - y, (w - 1) - x);
+            pPixelBuffer[Index(x, y)] = Format::FromColor(Color(x ^ y, (h - 1) - y, (w - 1) - x));
         }
     }
 }
 
-Color Surface::GetPixel(int x, int y) const
+template <typename Format>
+void BasicSurface<Format>::Fill(const Color& c)
+{
+    std::fill(pPixelBuffer.get(), pPixelBuffer.get() + BufferSize(w, h, layout), Format::FromColor(c));
+}
+
+template <typename Format>
+BasicSurface<Format> BasicSurface<Format>::ToLayout(Layout newLayout) const
+{
+    BasicSurface s(w, h, newLayout);
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            s.pPixelBuffer[s.Index(x, y)] = pPixelBuffer[Index(x, y)];
+        }
+    }
+    return s;
+}
+
+template <typename Format>
+Color BasicSurface<Format>::GetPixel(int x, int y) const
 {
     assert(x >= 0);
     assert(y >= 0);
     assert(x < w);
     assert(y < h);
-    return pPixelBuffer[y * h + x];
+    return Format::ToColor(pPixelBuffer[Index(x, y)]);
 }
 
-Color Surface::GetPixelUV(float u, float v) const
+template <typename Format>
+Color BasicSurface<Format>::GetPixelUV(float u, float v) const
 {
     assert(u >= 0.0f);
     assert(v >= 0.0f);
@@ -51,11 +77,194 @@ Color Surface::GetPixelUV(float u, float v) const
     return GetPixel(x, y);
 }
 
-void Surface::PutPixel(int x, int y, const Color& c)
+// filters between the 4 texels nearest to the given coordinates
+template <typename Format>
+Color BasicSurface<Format>::GetPixelUVBilinear(float u, float v) const
+{
+    assert(u >= 0.0f);
+    assert(v >= 0.0f);
+    assert(u <= 1.0f);
+    assert(v <= 1.0f);
+    
+    return Bilinear(CalcBilinearTap(u, v, w, h));
+}
+
+// texel centers are at half-integer positions, and lookups are clamped at the edges
+SurfaceBase::BilinearTap SurfaceBase::CalcBilinearTap(float u, float v, int w, int h)
+{
+    float x = u * static_cast<float>(w) - 0.5f;
+    float y = v * static_cast<float>(h) - 0.5f;
+    Utils::Clamp(x, 0.0f, static_cast<float>(w - 1));
+    Utils::Clamp(y, 0.0f, static_cast<float>(h - 1));
+    
+    BilinearTap t;
+    t.x0 = static_cast<int>(x);
+    t.y0 = static_cast<int>(y);
+    t.x1 = std::min(t.x0 + 1, w - 1);
+    t.y1 = std::min(t.y0 + 1, h - 1);
+    t.fx = static_cast<int>((x - static_cast<float>(t.x0)) * 256.0f);
+    t.fy = static_cast<int>((y - static_cast<float>(t.y0)) * 256.0f);
+    return t;
+}
+
+// the same as GetPixelUVBilinear, but for a whole span of coordinates at once - the texel
+// coordinates and weights are worked out 4 at a time
+template <typename Format>
+void BasicSurface<Format>::GetPixelsUVBilinear(const float* pU, const float* pV, unsigned int* pOut, int n) const
+{
+    int i = 0;
+#ifdef SIMD_SSE2
+    const __m128 scaleX = _mm_set1_ps(static_cast<float>(w));
+    const __m128 scaleY = _mm_set1_ps(static_cast<float>(h));
+    const __m128 maxX = _mm_set1_ps(static_cast<float>(w - 1));
+    const __m128 maxY = _mm_set1_ps(static_cast<float>(h - 1));
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 fixedOne = _mm_set1_ps(256.0f);
+    alignas(16) int x0[4], y0[4], fx[4], fy[4];
+    BilinearTap t;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 x = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(pU + i), scaleX), half);
+        __m128 y = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(pV + i), scaleY), half);
+        x = _mm_min_ps(_mm_max_ps(x, zero), maxX);
+        y = _mm_min_ps(_mm_max_ps(y, zero), maxY);
+        
+        // (coordinates are never negative at this point, so truncation is the same as floor)
+        __m128i xi = _mm_cvttps_epi32(x);
+        __m128i yi = _mm_cvttps_epi32(y);
+        _mm_store_si128(reinterpret_cast<__m128i*>(x0), xi);
+        _mm_store_si128(reinterpret_cast<__m128i*>(y0), yi);
+        _mm_store_si128(reinterpret_cast<__m128i*>(fx),
+                        _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(x, _mm_cvtepi32_ps(xi)), fixedOne)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(fy),
+                        _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(y, _mm_cvtepi32_ps(yi)), fixedOne)));
+        
+        for (int j = 0; j < 4; j++)
+        {
+            t.x0 = x0[j];
+            t.y0 = y0[j];
+            t.x1 = std::min(x0[j] + 1, w - 1);
+            t.y1 = std::min(y0[j] + 1, h - 1);
+            t.fx = fx[j];
+            t.fy = fy[j];
+            pOut[i + j] = Bilinear(t);
+        }
+    }
+#endif
+    for (; i < n; i++)
+        pOut[i] = GetPixelUVBilinear(pU[i], pV[i]);
+}
+
+// blends 4 texels with 8-bit fixed point weights - all 4 channels (ARGB) are filtered together
+unsigned int SurfaceBase::BlendBilinear(unsigned int c00, unsigned int c10, unsigned int c01, unsigned int c11, int fx, int fy)
+{
+#ifdef SIMD_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    
+    // widen each row's pair of texels to 16 bits per channel: [left ARGB, right ARGB]
+    __m128i top = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(c00)), zero);
+    top = _mm_unpacklo_epi64(top, _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(c10)), zero));
+    __m128i bottom = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(c01)), zero);
+    bottom = _mm_unpacklo_epi64(bottom, _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(c11)), zero));
+    
+    // horizontal blend - weight the left/right texels, then add the upper half onto the lower half
+    // (products are at most 255 * 256, which still fits in 16 unsigned bits)
+    const __m128i wx = _mm_set_epi16(static_cast<short>(fx), static_cast<short>(fx),
+                                     static_cast<short>(fx), static_cast<short>(fx),
+                                     static_cast<short>(256 - fx), static_cast<short>(256 - fx),
+                                     static_cast<short>(256 - fx), static_cast<short>(256 - fx));
+    top = _mm_mullo_epi16(top, wx);
+    top = _mm_srli_epi16(_mm_add_epi16(top, _mm_srli_si128(top, 8)), 8);
+    bottom = _mm_mullo_epi16(bottom, wx);
+    bottom = _mm_srli_epi16(_mm_add_epi16(bottom, _mm_srli_si128(bottom, 8)), 8);
+    
+    // vertical blend
+    __m128i res = _mm_add_epi16(_mm_mullo_epi16(top, _mm_set1_epi16(static_cast<short>(256 - fy))),
+                                _mm_mullo_epi16(bottom, _mm_set1_epi16(static_cast<short>(fy))));
+    res = _mm_srli_epi16(res, 8);
+    
+    return static_cast<unsigned int>(_mm_cvtsi128_si32(_mm_packus_epi16(res, res)));
+#else
+    unsigned int res = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        unsigned int top = (((c00 >> shift) & 0xFF) * (256 - fx) + ((c10 >> shift) & 0xFF) * fx) >> 8;
+        unsigned int bottom = (((c01 >> shift) & 0xFF) * (256 - fx) + ((c11 >> shift) & 0xFF) * fx) >> 8;
+        res |= (((top * (256 - fy) + bottom * fy) >> 8) << shift);
+    }
+    return res;
+#endif
+}
+
+template <typename Format>
+void BasicSurface<Format>::PutPixel(int x, int y, const Color& c)
 {
-    assert(x > 0);
-    assert(y > 0);
+    assert(x >= 0);
+    assert(y >= 0);
     assert(x < w);
     assert(y < h);
-    pPixelBuffer[y * w + x] = c;
-}
\ No newline at end of file
+    pPixelBuffer[Index(x, y)] = Format::FromColor(c);
+}
+
+template <typename Format>
+void BasicSurface<Format>::AddPixel(int x, int y, const Color& c)
+{
+    assert(x >= 0);
+    assert(y >= 0);
+    assert(x < w);
+    assert(y < h);
+    Pixel& p = pPixelBuffer[Index(x, y)];
+    p = Format::Add(p, Format::FromColor(c));
+}
+
+template <typename Format>
+void BasicSurface<Format>::WriteSpan(int y, int x0, int x1, const unsigned int* pColors)
+{
+    assert(x0 >= 0);
+    assert(x1 <= w);
+    assert(y >= 0);
+    assert(y < h);
+    if (x1 <= x0)
+        return;
+    
+    if (layout == Layout::Tiled)
+    {
+        for (int x = x0; x < x1; x++)
+            pPixelBuffer[Index(x, y)] = Format::FromColor(pColors[x - x0]);
+        return;
+    }
+    
+    // (colors are already in the surface's format when it's ARGB8888, so the span is just copied)
+    Pixel* pDst = GetRow(y) + x0;
+    if constexpr (std::is_same<Format, PixelFormats::ARGB8888>::value)
+        memcpy(pDst, pColors, (x1 - x0) * sizeof(Pixel));
+    else
+        for (int i = 0; i < x1 - x0; i++)
+            pDst[i] = Format::FromColor(pColors[i]);
+}
+
+template <typename Format>
+void BasicSurface<Format>::FillSpan(int y, int x0, int x1, const Color& c)
+{
+    assert(x0 >= 0);
+    assert(x1 <= w);
+    assert(y >= 0);
+    assert(y < h);
+    if (x1 <= x0)
+        return;
+    
+    // (the color is only converted once, for the whole span)
+    const Pixel p = Format::FromColor(c);
+    if (layout == Layout::Tiled)
+    {
+        for (int x = x0; x < x1; x++)
+            pPixelBuffer[Index(x, y)] = p;
+        return;
+    }
+    std::fill_n(GetRow(y) + x0, x1 - x0, p);
+}
+
+template class BasicSurface<PixelFormats::ARGB8888>;
+template class BasicSurface<PixelFormats::RGB565>;
+template class BasicSurface<PixelFormats::RGBAFloat>;
\ No newline at end of file
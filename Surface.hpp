@@ -11,31 +11,164 @@
 
 #include <iostream>
 #include <memory>
+#include <new>
+#include <cassert>
 #include "Color.hpp"
+#include "PixelFormat.hpp"
 
-class Surface
+// the parts of a surface that are the same whatever format its pixels are in
+class SurfaceBase
 {
 public:
-    Surface(int w, int h) :
+    // the order in which pixels are stored in memory
+    enum class Layout
+    {
+        Linear, // row by row
+        Tiled   // 4x4 blocks of pixels (one cache line each), themselves stored row by row - lookups
+                // that wander in any direction (e.g. a rotated texture) stay in nearby memory
+    };
+
+    // the 4 texels and 8-bit fixed point weights (256 = 1.0) used for a bilinear lookup
+    struct BilinearTap
+    {
+        int x0, y0, x1, y1;
+        int fx, fy;
+    };
+
+    static BilinearTap CalcBilinearTap(float u, float v, int w, int h);
+    static unsigned int BlendBilinear(unsigned int c00, unsigned int c10, unsigned int c01, unsigned int c11, int fx, int fy);
+
+    // pixel buffers start on a cache line, as do the rows of linear surfaces
+    static constexpr size_t CacheLineSize = 64;
+
+protected:
+    static constexpr int TileShift = 2;
+    static constexpr int TileDim = 1 << TileShift;
+    static constexpr int TileMask = TileDim - 1;
+};
+
+// a 2D array of pixels, stored in the given format (see PixelFormats) - whatever the format,
+// pixels are read and written as colors
+template <typename Format>
+class BasicSurface : public SurfaceBase
+{
+public:
+    typedef typename Format::Pixel Pixel;
+
+    BasicSurface(int w, int h, Layout layout = Layout::Linear) :
+        w(w),
+        h(h),
+        pitch(Pitch(w, layout)),
+        layout(layout),
+        tilesX((w + TileDim - 1) / TileDim),
+        pPixelBuffer(AllocatePixels(w, h, layout))
+    {}
+    // wraps pixels stored elsewhere (e.g. in a memory-mapped file), which are kept alive by
+    // the shared pointer's owner - they must be laid out as if allocated by this class
+    BasicSurface(int w, int h, Layout layout, std::shared_ptr<Pixel[]> pPixels) :
         w(w),
         h(h),
-        pPixelBuffer(new unsigned int[w * h])
+        pitch(Pitch(w, layout)),
+        layout(layout),
+        tilesX((w + TileDim - 1) / TileDim),
+        pPixelBuffer(std::move(pPixels))
     {}
-    Surface(Surface&) = delete;
-    Surface(Surface&& s) = default;
+    BasicSurface(BasicSurface&) = delete;
+    BasicSurface(BasicSurface&& s) = default;
+    BasicSurface& operator=(BasicSurface&& s) = default;
     int Width() const { return w; };
     int Height() const { return h; };
-    unsigned int* GetPixelBuffer() const { return pPixelBuffer.get(); }
+    Layout GetLayout() const { return layout; }
+    size_t SizeBytes() const { return SizeBytes(w, h, layout); }
+    static size_t SizeBytes(int w, int h, Layout layout) { return static_cast<size_t>(BufferSize(w, h, layout)) * sizeof(Pixel); }
+    // (uninitialized, cache line aligned storage for a surface's pixels - e.g. to read them into)
+    static std::shared_ptr<Pixel[]> AllocatePixels(int w, int h, Layout layout)
+    {
+        Pixel* p = static_cast<Pixel*>(::operator new[](SizeBytes(w, h, layout), std::align_val_t(CacheLineSize)));
+        return std::shared_ptr<Pixel[]>(p, [](Pixel* p) { ::operator delete[](p, std::align_val_t(CacheLineSize)); });
+    }
+    // (raw access to the pixel buffer only makes sense for the linear layout, where each row is
+    // Pitch() pixels after the one before it)
+    Pixel* GetPixelBuffer() const { return pPixelBuffer.get(); }
+    int Pitch() const { return pitch; }
+    Pixel* GetRow(int y) const
+    {
+        assert(layout == Layout::Linear);
+        assert(y >= 0 && y < h);
+        return pPixelBuffer.get() + y * pitch;
+    }
+    // writes the pixels from x0 up to (but not including) x1 on a row - a whole span at a time
+    // saves the per-pixel checks and conversion calls of PutPixel()
+    void WriteSpan(int y, int x0, int x1, const unsigned int* pColors);
+    // (the same, where every pixel of the span is the same color)
+    void FillSpan(int y, int x0, int x1, const Color& c);
+    BasicSurface ToLayout(Layout newLayout) const;
+    // copies the surface into another format (e.g. to present a float surface)
+    template <typename OtherFormat>
+    BasicSurface<OtherFormat> ToFormat() const
+    {
+        BasicSurface<OtherFormat> s(w, h, layout);
+        for (int y = 0; y < h; y++)
+            for (int x = 0; x < w; x++)
+                s.PutPixel(x, y, GetPixel(x, y));
+        return s;
+    }
     Color GetPixel(int x, int y) const;
     Color GetPixelUV(float u, float v) const;
+    Color GetPixelUVBilinear(float u, float v) const;
+    void GetPixelsUVBilinear(const float* pU, const float* pV, unsigned int* pOut, int n) const;
     void PutPixel(int x, int y, const Color& c);
+    // adds to a pixel rather than replacing it (see the format's Add())
+    void AddPixel(int x, int y, const Color& c);
+    void Fill(const Color& c);
     void FillXorPattern();
-    ~Surface() = default;
-    
+    ~BasicSurface() = default;
+
 private:
+    // rows of linear surfaces are padded out to a whole number of cache lines
+    static int Pitch(int w, Layout layout)
+    {
+        constexpr int RowAlign = static_cast<int>(CacheLineSize / sizeof(Pixel));
+        if (layout == Layout::Tiled)
+            return w;
+        return (w + RowAlign - 1) / RowAlign * RowAlign;
+    }
+    static int BufferSize(int w, int h, Layout layout)
+    {
+        // tiled surfaces are padded out to whole tiles
+        if (layout == Layout::Tiled)
+            return ((w + TileDim - 1) / TileDim) * ((h + TileDim - 1) / TileDim) * TileDim * TileDim;
+        return Pitch(w, layout) * h;
+    }
+    Color Bilinear(const BilinearTap& t) const
+    {
+        return BlendBilinear(Format::ToColor(pPixelBuffer[Index(t.x0, t.y0)]), Format::ToColor(pPixelBuffer[Index(t.x1, t.y0)]),
+                             Format::ToColor(pPixelBuffer[Index(t.x0, t.y1)]), Format::ToColor(pPixelBuffer[Index(t.x1, t.y1)]),
+                             t.fx, t.fy);
+    }
+    int Index(int x, int y) const
+    {
+        // (x and y are never negative, so shifts and masks can stand in for division/modulo)
+        if (layout == Layout::Tiled)
+            return (((y >> TileShift) * tilesX + (x >> TileShift)) << (2 * TileShift)) |
+                ((y & TileMask) << TileShift) | (x & TileMask);
+        return y * pitch + x;
+    }
+
     int w;
     int h;
-    std::unique_ptr<unsigned int[]> pPixelBuffer;
+    int pitch;
+    Layout layout;
+    int tilesX;
+    std::shared_ptr<Pixel[]> pPixelBuffer;
 };
 
+// (the surfaces for each format are compiled once, in Surface.cpp)
+extern template class BasicSurface<PixelFormats::ARGB8888>;
+extern template class BasicSurface<PixelFormats::RGB565>;
+extern template class BasicSurface<PixelFormats::RGBAFloat>;
+
+// the usual format, which textures are stored in
+typedef BasicSurface<PixelFormats::ARGB8888> Surface;
+
 #endif /* Surface_hpp */
@@ -0,0 +1,314 @@
+//
+//  Texture.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "Texture.hpp"
+#include "Utils.hpp"
+
+Texture::Texture(Surface&& s, bool generateMips, Surface::Layout layout):
+    w(s.Width()),
+    h(s.Height()),
+    contentHash(CalcContentHash(s))
+{
+    // mips are generated from linear surfaces...
+    if (s.GetLayout() == Surface::Layout::Linear)
+        levels.push_back(std::move(s));
+    else
+        levels.push_back(s.ToLayout(Surface::Layout::Linear));
+    
+    // keep halving until reaching a single texel
+    if (generateMips)
+        while (levels.back().Width() > 1 || levels.back().Height() > 1)
+            levels.push_back(Downsample(levels.back()));
+    
+    // ...and only then rearranged for sampling
+    if (layout != Surface::Layout::Linear)
+        for (auto& level : levels)
+            level = level.ToLayout(layout);
+    
+    numLevels = static_cast<int>(levels.size());
+    residentLevel = 0;
+    requestedLevel = numLevels;
+}
+
+Texture::Texture(std::vector<Surface>&& levels, uint64_t contentHash, int residentLevel):
+    w(levels[0].Width()),
+    h(levels[0].Height()),
+    numLevels(static_cast<int>(levels.size())),
+    contentHash(contentHash),
+    residentLevel(residentLevel),
+    requestedLevel(numLevels),
+    levels(std::move(levels))
+{
+}
+
+Texture::Texture(std::vector<BC1Surface>&& compressedLevels, uint64_t contentHash, int residentLevel):
+    w(compressedLevels[0].Width()),
+    h(compressedLevels[0].Height()),
+    numLevels(static_cast<int>(compressedLevels.size())),
+    contentHash(contentHash),
+    residentLevel(residentLevel),
+    requestedLevel(numLevels),
+    compressedLevels(std::move(compressedLevels))
+{
+}
+
+// (written out, as atomics can't be moved - a texture isn't sampled while it's being moved)
+Texture::Texture(Texture&& t):
+    w(t.w),
+    h(t.h),
+    numLevels(t.numLevels),
+    contentHash(t.contentHash),
+    residentLevel(t.residentLevel),
+    requestedLevel(t.requestedLevel.load(std::memory_order_relaxed)),
+    levels(std::move(t.levels)),
+    compressedLevels(std::move(t.compressedLevels))
+{
+}
+
+Texture& Texture::operator=(Texture&& t)
+{
+    w = t.w;
+    h = t.h;
+    numLevels = t.numLevels;
+    contentHash = t.contentHash;
+    residentLevel = t.residentLevel;
+    requestedLevel.store(t.requestedLevel.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    levels = std::move(t.levels);
+    compressedLevels = std::move(t.compressedLevels);
+    return *this;
+}
+
+// replaces all levels with BC1 compressed versions (which drops any alpha channel)
+void Texture::Compress()
+{
+    assert(residentLevel == 0);
+    if (IsCompressed())
+        return;
+    
+    for (const auto& level : levels)
+        compressedLevels.emplace_back(level);
+    levels.clear();
+}
+
+bool Texture::SameTexels(const Texture& t) const
+{
+    assert(residentLevel == 0 && t.residentLevel == 0);
+    if (w != t.w || h != t.h || numLevels != t.numLevels || IsCompressed() != t.IsCompressed())
+        return false;
+    
+    for (int i = 0; i < numLevels; i++)
+    {
+        if (IsCompressed())
+        {
+            const BC1Surface& a = compressedLevels[i];
+            const BC1Surface& b = t.compressedLevels[i];
+            if (a.Width() != b.Width() || a.Height() != b.Height() ||
+                memcmp(a.GetBlockBuffer(), b.GetBlockBuffer(), a.SizeBytes()) != 0)
+                return false;
+        }
+        else
+        {
+            // (pixel by pixel, as the padding of the two buffers needn't match)
+            const Surface& a = levels[i];
+            const Surface& b = t.levels[i];
+            if (a.Width() != b.Width() || a.Height() != b.Height())
+                return false;
+            for (int y = 0; y < a.Height(); y++)
+                for (int x = 0; x < a.Width(); x++)
+                    if (static_cast<unsigned int>(a.GetPixel(x, y)) != static_cast<unsigned int>(b.GetPixel(x, y)))
+                        return false;
+        }
+    }
+    return true;
+}
+
+// (only counts the resident levels)
+size_t Texture::SizeBytes() const
+{
+    size_t size = 0;
+    for (int i = residentLevel; i < numLevels; i++)
+        size += LevelSizeBytes(i);
+    return size;
+}
+
+size_t Texture::LevelSizeBytes(int level) const
+{
+    return IsCompressed() ? compressedLevels[level].SizeBytes() : levels[level].SizeBytes();
+}
+
+void Texture::EvictLevel()
+{
+    assert(residentLevel < numLevels - 1);
+    
+    // (the placeholder keeps the level's dimensions, but not its texels)
+    if (IsCompressed())
+    {
+        const BC1Surface& s = compressedLevels[residentLevel];
+        compressedLevels[residentLevel] = BC1Surface(s.Width(), s.Height(), nullptr);
+    }
+    else
+    {
+        const Surface& s = levels[residentLevel];
+        levels[residentLevel] = Surface(s.Width(), s.Height(), s.GetLayout(), nullptr);
+    }
+    residentLevel++;
+}
+
+void Texture::RestoreLevel(Texture&& levelTexture)
+{
+    assert(residentLevel > 0);
+    assert(levelTexture.NumLevels() == 1);
+    assert(levelTexture.IsCompressed() == IsCompressed());
+    
+    residentLevel--;
+    if (IsCompressed())
+    {
+        assert(levelTexture.Width() == compressedLevels[residentLevel].Width());
+        compressedLevels[residentLevel] = std::move(levelTexture.compressedLevels[0]);
+    }
+    else
+    {
+        assert(levelTexture.Width() == levels[residentLevel].Width());
+        levels[residentLevel] = std::move(levelTexture.levels[0]);
+    }
+}
+
+int Texture::TakeRequestedLevel()
+{
+    return requestedLevel.exchange(numLevels, std::memory_order_relaxed);
+}
+
+// box filters each 2x2 block of texels down to a single texel - for odd dimensions, the last
+// row/column is simply folded into the one before it
+Surface Texture::Downsample(const Surface& s)
+{
+    int w = std::max(s.Width() / 2, 1);
+    int h = std::max(s.Height() / 2, 1);
+    Surface d(w, h);
+    
+    for (int y = 0; y < h; y++)
+    {
+        const unsigned int* pSrc0 = s.GetRow(std::min(y * 2, s.Height() - 1));
+        const unsigned int* pSrc1 = s.GetRow(std::min(y * 2 + 1, s.Height() - 1));
+        unsigned int* pDst = d.GetRow(y);
+        for (int x = 0; x < w; x++)
+        {
+            int x0 = std::min(x * 2, s.Width() - 1);
+            int x1 = std::min(x * 2 + 1, s.Width() - 1);
+            
+            Color c00 = pSrc0[x0];
+            Color c01 = pSrc0[x1];
+            Color c10 = pSrc1[x0];
+            Color c11 = pSrc1[x1];
+            
+            // (adding 2 rounds to nearest)
+            pDst[x] = Color((c00.R() + c01.R() + c10.R() + c11.R() + 2) / 4,
+                            (c00.G() + c01.G() + c10.G() + c11.G() + 2) / 4,
+                            (c00.B() + c01.B() + c10.B() + c11.B() + 2) / 4);
+        }
+    }
+    
+    return d;
+}
+
+// FNV-1a over the dimensions and pixels of the original image (in row order, whatever its layout)
+uint64_t Texture::CalcContentHash(const Surface& s)
+{
+    uint64_t hash = 14695981039346656037ull;
+    auto hashValue = [&hash](unsigned int value)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+    };
+    
+    hashValue(static_cast<unsigned int>(s.Width()));
+    hashValue(static_cast<unsigned int>(s.Height()));
+    for (int y = 0; y < s.Height(); y++)
+        for (int x = 0; x < s.Width(); x++)
+            hashValue(s.GetPixel(x, y));
+    return hash;
+}
+
+// calculates the level of detail from the screen-space derivatives of the texture coordinates,
+// i.e. log2 of the number of (level 0) texels covered by a step of one pixel
+float Texture::ComputeLod(const Vec2& dUVdx, const Vec2& dUVdy) const
+{
+    float w = static_cast<float>(Width());
+    float h = static_cast<float>(Height());
+    Vec2 dTexelsdx(dUVdx.x * w, dUVdx.y * h);
+    Vec2 dTexelsdy(dUVdy.x * w, dUVdy.y * h);
+    
+    // (half of log2 of the squared length avoids a square root)
+    float rhoSq = std::max(dTexelsdx.MagSq(), dTexelsdy.MagSq());
+    return 0.5f * log2f(rhoSq);
+}
+
+int Texture::NearestLevel(float lod) const
+{
+    // (also catches a NaN level of detail - and clamps before converting, as it may be infinite)
+    if (!(lod > 0.0f))
+        return 0;
+    return static_cast<int>(std::min(lod + 0.5f, static_cast<float>(numLevels - 1)));
+}
+
+Color Texture::Sample(float u, float v, float lod, Filter filter) const
+{
+    lod = ResidentLod(lod);
+    
+    // magnification (or no mips) always reads from the full resolution level
+    float maxLod = static_cast<float>(numLevels - 1);
+    if (!(lod > 0.0f))
+        return SampleLevel(0, u, v, filter);
+    if (lod >= maxLod)
+        return SampleLevel(numLevels - 1, u, v, filter);
+    
+    if (filter == Filter::Trilinear)
+    {
+        int level = static_cast<int>(lod);
+        float frac = lod - static_cast<float>(level);
+        Color c1 = SampleLevel(level, u, v, filter);
+        Color c2 = SampleLevel(level + 1, u, v, filter);
+        return Color::Lerp(c1, c2, Color::ToFixed(frac));
+    }
+    else
+    {
+        // (round to the nearest level)
+        return SampleLevel(static_cast<int>(lod + 0.5f), u, v, filter);
+    }
+}
+
+// samples a whole span of coordinates, all from the level nearest to a single level of detail
+void Texture::SampleSpan(const float* pU, const float* pV, float lod, Filter filter, unsigned int* pOut, int n) const
+{
+    int level = NearestLevel(ResidentLod(lod));
+    
+    if (IsCompressed())
+    {
+        for (int i = 0; i < n; i++)
+            pOut[i] = SampleLevel(level, pU[i], pV[i], filter);
+        return;
+    }
+    
+    const Surface& s = levels[level];
+    if (filter == Filter::Point)
+    {
+        for (int i = 0; i < n; i++)
+            pOut[i] = s.GetPixelUV(pU[i], pV[i]);
+    }
+    else
+    {
+        s.GetPixelsUVBilinear(pU, pV, pOut, n);
+    }
+}
@@ -0,0 +1,120 @@
+//
+//  Texture.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef Texture_hpp
+#define Texture_hpp
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include "Surface.hpp"
+#include "BC1Surface.hpp"
+#include "Color.hpp"
+#include "Vec2.hpp"
+
+// a sampled image, along with a chain of successively half-sized (mip) levels generated from it
+// minified lookups read from a smaller level, which both reduces aliasing and keeps the texels
+// being read close together in memory
+// (levels can optionally be stored tiled, which can help when large textures are sampled at
+// an angle, walking across rows rather than along them - or, for opaque textures, compressed,
+// which cuts memory use and bandwidth to 1/8th)
+// the finer levels of a texture need not all be in memory (see TextureResidency) - levels finer
+// than the resident level are placeholders without any texels, and sampling falls back to the
+// finest level that is resident
+class Texture
+{
+public:
+    enum class Filter
+    {
+        Point,      // nearest texel from the nearest level
+        Bilinear,   // 4 nearest texels blended, from the nearest level
+        Trilinear   // 4 nearest texels blended, from each of the two nearest levels, blended between levels
+    };
+    
+    Texture(Surface&& s, bool generateMips = true, Surface::Layout layout = Surface::Layout::Linear);
+    // (from already prepared levels, e.g. loaded from a file)
+    Texture(std::vector<Surface>&& levels, uint64_t contentHash, int residentLevel = 0);
+    Texture(std::vector<BC1Surface>&& compressedLevels, uint64_t contentHash, int residentLevel = 0);
+    Texture(Texture&) = delete;
+    Texture(Texture&& t);
+    Texture& operator=(Texture&& t);
+    int Width() const { return w; }
+    int Height() const { return h; }
+    int NumLevels() const { return numLevels; }
+    // (uncompressed textures only)
+    const Surface& GetLevel(int level) const { return levels[level]; }
+    // (compressed textures only)
+    const BC1Surface& GetCompressedLevel(int level) const { return compressedLevels[level]; }
+    bool IsCompressed() const { return !compressedLevels.empty(); }
+    void Compress();
+    size_t SizeBytes() const;
+    // identifies the image the texture was made from - textures made from identical images
+    // have the same hash, however they are stored
+    uint64_t GetContentHash() const { return contentHash; }
+    // whether every level has the same size and texels as the other texture's, stored the same way
+    // (both must be entirely in memory) - e.g. to tell apart images that merely have the same hash
+    bool SameTexels(const Texture& t) const;
+    // the finest level whose texels are in memory (levels are only ever missing from the fine end)
+    int GetResidentLevel() const { return residentLevel; }
+    size_t LevelSizeBytes(int level) const;
+    // drops the finest resident level
+    void EvictLevel();
+    // fills in the level just finer than the resident level, from a texture holding only that level
+    void RestoreLevel(Texture&& levelTexture);
+    // returns the finest level sampling has asked for since the last call (or NumLevels() if the
+    // texture hasn't been sampled)
+    int TakeRequestedLevel();
+    float ComputeLod(const Vec2& dUVdx, const Vec2& dUVdy) const;
+    // the level a (point or bilinear) sample at the given level of detail reads from, whether or
+    // not it's resident
+    int NearestLevel(float lod) const;
+    // (the filter is passed in rather than being part of the texture, so that a texture can be
+    // shared between users wanting different filtering)
+    Color Sample(float u, float v, float lod, Filter filter) const;
+    void SampleSpan(const float* pU, const float* pV, float lod, Filter filter, unsigned int* pOut, int n) const;
+    ~Texture() = default;
+    
+private:
+    static Surface Downsample(const Surface& s);
+    static uint64_t CalcContentHash(const Surface& s);
+    // notes the level sampling would like, and returns the level of detail to actually use
+    float ResidentLod(float lod) const
+    {
+        int level = (lod > 0.0f) ? std::min(static_cast<int>(lod), numLevels - 1) : 0;
+        // (an atomic min - a failed exchange reloads whatever another thread has since asked for)
+        int requested = requestedLevel.load(std::memory_order_relaxed);
+        while (level < requested)
+            if (requestedLevel.compare_exchange_weak(requested, level, std::memory_order_relaxed))
+                break;
+        
+        // (also catches a NaN level of detail)
+        float residentLod = static_cast<float>(residentLevel);
+        return (lod >= residentLod) ? lod : residentLod;
+    }
+    Color SampleLevel(int level, float u, float v, Filter filter) const
+    {
+        if (IsCompressed())
+            return (filter == Filter::Point) ? compressedLevels[level].GetPixelUV(u, v) : compressedLevels[level].GetPixelUVBilinear(u, v);
+        return (filter == Filter::Point) ? levels[level].GetPixelUV(u, v) : levels[level].GetPixelUVBilinear(u, v);
+    }
+    
+    int w;
+    int h;
+    int numLevels;
+    uint64_t contentHash;
+    int residentLevel;
+    // (only written to by sampling, so that a texture can be sampled through a const reference -
+    // and atomic, as a shared texture may be sampled from several threads at once)
+    mutable std::atomic<int> requestedLevel;
+    // (only one of these is populated, depending on whether the texture has been compressed)
+    std::vector<Surface> levels;
+    std::vector<BC1Surface> compressedLevels;
+};
+
+#endif /* Texture_hpp */
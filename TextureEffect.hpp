@@ -9,19 +9,25 @@
 #ifndef TextureEffect_hpp
 #define TextureEffect_hpp
 
-#include "Surface.hpp"
+#include <cmath>
+#include <vector>
+#include "Texture.hpp"
+#include "TextureManager.hpp"
 #include "Vec3.hpp"
 #include "Vec2.hpp"
 #include "Mat3.hpp"
 #include "Utils.hpp"
+#include "Color.hpp"
+#include "ColorOps.hpp"
 #include "Triangle.hpp"
+#include "Interpolants.hpp"
 
 // textures triangles
 // entire triangles are lit according to their plane normals
 class TextureEffect
 {
 public:
-    // contains an (interpolated) attribute for texture coordinates
+    // a position and texture coordinates
     class Vertex
     {
     public:
@@ -31,67 +37,23 @@ public:
             textureCoords(textureCoords)
         {
         }
-        Vertex& operator=(const Vertex& rhs)
-        {
-            v = rhs.v;
-            textureCoords = rhs.textureCoords;
-            return *this;
-        }
-        Vertex operator+(const Vertex& rhs) const
-        {
-            return Vertex(v + rhs.v, textureCoords + rhs.textureCoords);
-        }
-        Vertex& operator+=(const Vertex& rhs)
-        {
-            *this = *this + rhs;
-            return *this;
-        }
-        Vertex operator-(const Vertex& rhs) const
-        {
-            return Vertex(v - rhs.v, textureCoords - rhs.textureCoords);
-        }
-        Vertex& operator-=(const Vertex& rhs)
-        {
-            *this = *this - rhs;
-            return *this;
-        }
-        Vertex operator*(float rhs) const
-        {
-            return Vertex(v * rhs, textureCoords * rhs);
-        }
-        Vertex& operator*=(float rhs)
-        {
-            *this = *this * rhs;
-            return *this;
-        }
-        Vertex operator/(float rhs) const
-        {
-            return Vertex(v / rhs, textureCoords / rhs);
-        }
-        Vertex& operator/=(float rhs)
-        {
-            *this = *this / rhs;
-            return *this;
-        }
-        Vertex InterpTo(const Vertex& rhs, float percent) const
-        {
-            return { v.InterpTo(rhs.v, percent),
-                textureCoords.InterpTo(rhs.textureCoords, percent) };
-        }
         
         Vec3 v;
         Vec2 textureCoords;
     };
+    
+    // the attributes interpolated across triangles (see Interpolants)
+    enum Attribute { U, V, NumAttributes };
 
     // only handles rotation and translation
     class VertexShader
     {
     public:
-        typedef Vertex OutVertex;
+        typedef InterpolatedVertex<NumAttributes> OutVertex;
         
         OutVertex operator()(const Vertex& vertex)
         {
-            return OutVertex(vertex.v * rotMat + transVec, vertex.textureCoords);
+            return OutVertex(vertex.v * rotMat + transVec, { vertex.textureCoords.x, vertex.textureCoords.y });
         };
         void BindRotation(const Mat3& rotMat)
         {
@@ -113,70 +75,8 @@ public:
     class GeometryShader
     {
     public:
-        // contains texture coordinates and light intensity (not interpolated)
-        class OutVertex
-        {
-        public:
-            OutVertex() = default;
-            OutVertex(const Vec3& v, const Vec2& textureCoords, float intensity):
-                v(v),
-                textureCoords(textureCoords),
-                intensity(intensity)
-            {}
-            OutVertex& operator=(const OutVertex& rhs)
-            {
-                v = rhs.v;
-                textureCoords = rhs.textureCoords;
-                intensity = rhs.intensity;
-                return *this;
-            }
-            OutVertex operator+(const OutVertex& rhs) const
-            {
-                return OutVertex(v + rhs.v, textureCoords + rhs.textureCoords, intensity);
-            }
-            OutVertex& operator+=(const OutVertex& rhs)
-            {
-                *this = *this + rhs;
-                return *this;
-            }
-            OutVertex operator-(const OutVertex& rhs) const
-            {
-                return OutVertex(v - rhs.v, textureCoords - rhs.textureCoords, intensity);
-            }
-            OutVertex& operator-=(const OutVertex& rhs)
-            {
-                *this = *this - rhs;
-                return *this;
-            }
-            OutVertex operator*(float rhs) const
-            {
-                return OutVertex(v * rhs, textureCoords * rhs, intensity);
-            }
-            OutVertex& operator*=(float rhs)
-            {
-                *this = *this * rhs;
-                return *this;
-            }
-            OutVertex operator/(float rhs) const
-            {
-                return OutVertex(v / rhs, textureCoords / rhs, intensity);
-            }
-            OutVertex& operator/=(float rhs)
-            {
-                *this = *this / rhs;
-                return *this;
-            }
-            OutVertex InterpTo(const OutVertex& rhs, float percent) const
-            {
-                return { v.InterpTo(rhs.v, percent),
-                    textureCoords.InterpTo(rhs.textureCoords, percent),
-                    intensity };
-            }
- 
-            Vec3 v;
-            Vec2 textureCoords;
-            float intensity;
-        };
+        // texture coordinates, plus light intensity as a flat attribute (not interpolated)
+        typedef InterpolatedVertex<NumAttributes, float> OutVertex;
         
         GeometryShader():
             lightDir(Vec3(1.0f, -1.0f, 2.0f).Norm()),
@@ -191,9 +91,9 @@ public:
             // figure out light intensity based on normal
             float intensity = std::max(-(norm * lightDir), ambientLight);
             
-            return Triangle<GeometryShader::OutVertex>({{t.v1.v, t.v1.textureCoords, intensity},
-                                                        {t.v2.v, t.v2.textureCoords, intensity},
-                                                        {t.v3.v, t.v3.textureCoords, intensity}});
+            return Triangle<GeometryShader::OutVertex>({{t.v1.v, t.v1.attr, intensity},
+                                                        {t.v2.v, t.v2.attr, intensity},
+                                                        {t.v3.v, t.v3.attr, intensity}});
         }
         
     private:
@@ -202,34 +102,122 @@ public:
     };
 
     // calculate pixel color based on light intensity and texture color
+    // (the texture level of detail is picked from the screen-space derivatives of the texture
+    // coordinates)
     class PixelShader
     {
     public:
-        PixelShader(Surface&& s):
-            s(std::move(s))
+        static constexpr bool UsesDerivatives = true;
+        // (rows are shaded a whole span at a time - see below)
+        typedef InterpolantSpan<NumAttributes> Span;
+        
+        // (textures are shared - see TextureManager)
+        PixelShader(std::shared_ptr<const Texture> pTexture):
+            pTexture(std::move(pTexture))
         {}
-        Color operator()(const GeometryShader::OutVertex& gsOutVertex)
+        Color operator()(const GeometryShader::OutVertex& gsOutVertex,
+                         const GeometryShader::OutVertex& ddx, const GeometryShader::OutVertex& ddy)
         {
             // clamp to UV coordinates in case of floating point errors
-            float u = gsOutVertex.textureCoords.x;
-            float v = gsOutVertex.textureCoords.y;
+            float u = gsOutVertex.attr[U];
+            float v = gsOutVertex.attr[V];
             Utils::Clamp(u, 0.0f, 1.0f);
             Utils::Clamp(v, 0.0f, 1.0f);
 
-            Color c = s.GetPixelUV(u, v);
+            Color c = pTexture->Sample(u, v, pTexture->ComputeLod(ddx.attr.GetVec2(U), ddy.attr.GetVec2(U)), filter);
 
             // shade according to light intensity
-            c *= gsOutVertex.intensity;
-
-            return c;
+            return c.Scaled(Color::ToFixed(gsOutVertex.flat));
         };
+        // (the same as above, for a whole row of pixels at once - the level of detail is worked
+        // out at either end of each stretch of the row, and stepped linearly in between)
+        void operator()(Span& attributes, const GeometryShader::OutVertex& first,
+                        const std::vector<SpanStretch<GeometryShader::OutVertex>>& stretches,
+                        unsigned int* pOut, int n)
+        {
+            float* pU = attributes[U];
+            float* pV = attributes[V];
+            for (int i = 0; i < n; i++)
+            {
+                Utils::Clamp(pU[i], 0.0f, 1.0f);
+                Utils::Clamp(pV[i], 0.0f, 1.0f);
+            }
+            
+            for (const auto& s : stretches)
+            {
+                float lodStart = pTexture->ComputeLod(s.ddxStart.attr.GetVec2(U), s.ddyStart.attr.GetVec2(U));
+                // (a single pixel, e.g. without subdivided spans, has nothing to step towards)
+                float lodEnd = (s.steps > 0) ? pTexture->ComputeLod(s.ddxEnd.attr.GetVec2(U), s.ddyEnd.attr.GetVec2(U)) : lodStart;
+                SampleStretch(pU + s.first, pV + s.first, lodStart, lodEnd, s.steps, pOut + s.first, s.n);
+            }
+            
+            ColorOps::Scale(pOut, Color::ToFixed(first.flat), pOut, n);
+        }
+       
+        void SetFilter(Texture::Filter f)
+        {
+            filter = f;
+        }
        
     private:
-        Surface s;
+        // samples n pixels whose level of detail goes linearly from lodStart to lodEnd over steps
+        // pixels
+        void SampleStretch(const float* pU, const float* pV, float lodStart, float lodEnd, int steps,
+                           unsigned int* pOut, int n) const
+        {
+            // (a level of detail that is infinite or NaN, e.g. for a texture seen edge on, is left
+            // as it is rather than stepped towards)
+            float lodStep = (steps > 0 && std::isfinite(lodEnd - lodStart)) ?
+                (lodEnd - lodStart) / static_cast<float>(steps) : 0.0f;
+            
+            if (filter == Texture::Filter::Trilinear)
+            {
+                // (blending between levels has no span version - and picks the level of detail per
+                // pixel anyway)
+                float lod = lodStart;
+                for (int i = 0; i < n; i++, lod += lodStep)
+                    pOut[i] = pTexture->Sample(pU[i], pV[i], lod, filter);
+                return;
+            }
+            
+            // (the level of detail only goes one way along the stretch, so if both ends read from
+            // the same level, so does everything in between)
+            if (pTexture->NearestLevel(lodStart) == pTexture->NearestLevel(lodEnd))
+            {
+                pTexture->SampleSpan(pU, pV, lodStart, filter, pOut, n);
+                return;
+            }
+            
+            // otherwise the stretch is split into runs of pixels that each read from one level
+            int runStart = 0;
+            float runLod = lodStart;
+            int runLevel = pTexture->NearestLevel(runLod);
+            float lod = lodStart;
+            for (int i = 1; i < n; i++)
+            {
+                lod += lodStep;
+                int level = pTexture->NearestLevel(lod);
+                if (level != runLevel)
+                {
+                    pTexture->SampleSpan(pU + runStart, pV + runStart, runLod, filter, pOut + runStart, i - runStart);
+                    runStart = i;
+                    runLod = lod;
+                    runLevel = level;
+                }
+            }
+            pTexture->SampleSpan(pU + runStart, pV + runStart, runLod, filter, pOut + runStart, n - runStart);
+        }
+        
+        std::shared_ptr<const Texture> pTexture;
+        Texture::Filter filter = Texture::Filter::Bilinear;
     };
     
     TextureEffect():
-        pixelShader(Graphics::LoadTexture("brick.bmp"))
+        pixelShader(TextureManager::Get().Load("brick.bmp"))
+    {}
+    // (for a texture that has already been loaded)
+    TextureEffect(std::shared_ptr<const Texture> pTexture):
+        pixelShader(std::move(pTexture))
     {}
     
     VertexShader vertexShader;
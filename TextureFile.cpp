@@ -0,0 +1,259 @@
+//
+//  TextureFile.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <filesystem>
+#include "TextureFile.hpp"
+
+constexpr char TextureFile::Magic[4];
+
+TextureFile::Exception::Exception(std::string filename, std::string msg):
+    filename(filename),
+    msg(msg)
+{
+}
+
+std::string TextureFile::Exception::GetMsg() const
+{
+    return "TextureFile::Exception: " + msg + ": " + filename;
+}
+
+void TextureFile::Save(const std::string& filename, const Texture& t)
+{
+    if (t.GetResidentLevel() != 0)
+        throw Exception(filename, "Texture is not entirely in memory");
+    
+    Header header;
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.width = static_cast<uint32_t>(t.Width());
+    header.height = static_cast<uint32_t>(t.Height());
+    header.numLevels = static_cast<uint32_t>(t.NumLevels());
+    header.format = t.IsCompressed() ? Format::BC1 : Format::ARGB8888;
+    header.layout = static_cast<uint32_t>(t.IsCompressed() ? Surface::Layout::Linear : t.GetLevel(0).GetLayout());
+    header.reserved = 0;
+    header.contentHash = t.GetContentHash();
+    
+    // lay out the levels one after the other, following the header and level table
+    std::vector<LevelEntry> entries(t.NumLevels());
+    std::vector<const void*> levelData(t.NumLevels());
+    uint64_t offset = sizeof(Header) + sizeof(LevelEntry) * entries.size();
+    for (int i = 0; i < t.NumLevels(); i++)
+    {
+        offset = (offset + DataAlignment - 1) / DataAlignment * DataAlignment;
+        
+        LevelEntry& e = entries[i];
+        e.offset = offset;
+        if (t.IsCompressed())
+        {
+            const BC1Surface& s = t.GetCompressedLevel(i);
+            e.width = static_cast<uint32_t>(s.Width());
+            e.height = static_cast<uint32_t>(s.Height());
+            e.size = s.SizeBytes();
+            levelData[i] = s.GetBlockBuffer();
+        }
+        else
+        {
+            const Surface& s = t.GetLevel(i);
+            e.width = static_cast<uint32_t>(s.Width());
+            e.height = static_cast<uint32_t>(s.Height());
+            e.size = s.SizeBytes();
+            levelData[i] = s.GetPixelBuffer();
+        }
+        
+        offset += e.size;
+    }
+    
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw Exception(filename, "Could not create texture file");
+    
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), sizeof(LevelEntry) * entries.size());
+    
+    const char padding[DataAlignment] = {};
+    uint64_t pos = sizeof(Header) + sizeof(LevelEntry) * entries.size();
+    for (int i = 0; i < t.NumLevels(); i++)
+    {
+        file.write(padding, static_cast<std::streamsize>(entries[i].offset - pos));
+        file.write(static_cast<const char*>(levelData[i]), static_cast<std::streamsize>(entries[i].size));
+        pos = entries[i].offset + entries[i].size;
+    }
+    
+    if (!file)
+        throw Exception(filename, "Could not write texture file");
+}
+
+std::string TextureFile::CacheFilename(const std::string& imageFilename, bool compressed)
+{
+    return std::filesystem::path(imageFilename).replace_extension(compressed ? ".bc1.tex" : ".tex").string();
+}
+
+// (a cache is still used if the original image has gone away)
+bool TextureFile::IsCacheCurrent(const std::string& imageFilename, const std::string& cacheFilename)
+{
+    std::error_code ec;
+    auto imageTime = std::filesystem::last_write_time(imageFilename, ec);
+    bool imageExists = !ec;
+    auto cacheTime = std::filesystem::last_write_time(cacheFilename, ec);
+    bool cacheExists = !ec;
+    
+    return cacheExists && (!imageExists || cacheTime >= imageTime);
+}
+
+bool TextureFile::UpdateCache(const std::string& imageFilename, bool compressed)
+{
+    std::string cacheFilename = CacheFilename(imageFilename, compressed);
+    
+    if (IsCacheCurrent(imageFilename, cacheFilename))
+    {
+        try
+        {
+            Header header;
+            std::vector<LevelEntry> entries;
+            Map(cacheFilename, header, entries);
+            return true;
+        }
+        catch (const Exception&)
+        {
+            // fall through and rebuild the cache
+        }
+    }
+    
+    try
+    {
+        Texture t(Graphics::LoadTexture(imageFilename));
+        if (compressed)
+            t.Compress();
+        Save(cacheFilename, t);
+        return true;
+    }
+    catch (const Exception&)
+    {
+        return false;
+    }
+}
+
+Texture TextureFile::LoadTail(const std::string& filename, size_t tailBytes)
+{
+    Header header;
+    std::vector<LevelEntry> entries;
+    auto pFile = Map(filename, header, entries);
+    
+    int numLevels = static_cast<int>(entries.size());
+    int firstLevel = numLevels - 1;
+    size_t size = entries[firstLevel].size;
+    while (firstLevel > 0 && size + entries[firstLevel - 1].size <= tailBytes)
+        size += entries[--firstLevel].size;
+    
+    std::vector<Surface> levels;
+    std::vector<BC1Surface> compressedLevels;
+    for (int i = 0; i < numLevels; i++)
+        AddLevel(pFile, header, entries[i], i < firstLevel, levels, compressedLevels);
+    
+    if (header.format == Format::BC1)
+        return Texture(std::move(compressedLevels), header.contentHash, firstLevel);
+    return Texture(std::move(levels), header.contentHash, firstLevel);
+}
+
+Texture TextureFile::LoadLevel(const std::string& filename, int level)
+{
+    Header header;
+    std::vector<LevelEntry> entries;
+    auto pFile = Map(filename, header, entries);
+    if (level < 0 || level >= static_cast<int>(entries.size()))
+        throw Exception(filename, "Texture file has no such level");
+    
+    std::vector<Surface> levels;
+    std::vector<BC1Surface> compressedLevels;
+    AddLevel(pFile, header, entries[level], false, levels, compressedLevels);
+    
+    if (header.format == Format::BC1)
+        return Texture(std::move(compressedLevels), header.contentHash);
+    return Texture(std::move(levels), header.contentHash);
+}
+
+void TextureFile::CheckHeader(const std::string& filename, const Header& header, uint64_t fileSize)
+{
+    if (memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+        throw Exception(filename, "Not a texture file (or an unsupported version)");
+    if (header.numLevels == 0 ||
+        (header.format != Format::ARGB8888 && header.format != Format::BC1) ||
+        (header.layout != static_cast<uint32_t>(Surface::Layout::Linear) &&
+         header.layout != static_cast<uint32_t>(Surface::Layout::Tiled)) ||
+        fileSize < sizeof(Header) + sizeof(LevelEntry) * header.numLevels)
+        throw Exception(filename, "Texture file is corrupt");
+}
+
+void TextureFile::CheckLevel(const std::string& filename, const Header& header, const LevelEntry& e, uint64_t fileSize)
+{
+    int w = static_cast<int>(e.width);
+    int h = static_cast<int>(e.height);
+    Surface::Layout layout = static_cast<Surface::Layout>(header.layout);
+    size_t expectedSize = (header.format == Format::BC1) ? BC1Surface::SizeBytes(w, h) : Surface::SizeBytes(w, h, layout);
+    if (w <= 0 || h <= 0 || e.size != expectedSize || e.offset % DataAlignment != 0 ||
+        e.offset > fileSize || e.size > fileSize - e.offset)
+        throw Exception(filename, "Texture file is corrupt");
+}
+
+std::shared_ptr<MappedFile> TextureFile::Map(const std::string& filename, Header& header, std::vector<LevelEntry>& entries)
+{
+    auto pFile = std::make_shared<MappedFile>(filename);
+    const unsigned char* pData = pFile->Data();
+    if (!pData)
+        throw Exception(filename, "Could not map texture file");
+    
+    // only the header and level table are checked - the level data is used exactly as it is
+    if (pFile->Size() < sizeof(Header))
+        throw Exception(filename, "Texture file is truncated");
+    memcpy(&header, pData, sizeof(header));
+    CheckHeader(filename, header, pFile->Size());
+    
+    entries.resize(header.numLevels);
+    memcpy(entries.data(), pData + sizeof(Header), sizeof(LevelEntry) * entries.size());
+    for (const auto& e : entries)
+        CheckLevel(filename, header, e, pFile->Size());
+    return pFile;
+}
+
+void TextureFile::AddLevel(const std::shared_ptr<MappedFile>& pFile, const Header& header, const LevelEntry& e,
+                           bool placeholder, std::vector<Surface>& levels, std::vector<BC1Surface>& compressedLevels)
+{
+    int w = static_cast<int>(e.width);
+    int h = static_cast<int>(e.height);
+    unsigned char* pLevel = pFile->Data() + e.offset;
+    
+    // the level's pages are read in now, by reading a byte from each - so that it's whoever
+    // loads the level that waits for the disk (e.g. TextureResidency's background thread),
+    // rather than whoever first samples it
+    if (!placeholder)
+    {
+        volatile unsigned char sink = 0;
+        for (uint64_t i = 0; i < e.size; i += PageSize)
+            sink = sink + pLevel[i];
+    }
+    
+    // the levels share ownership of the mapping, which stays alive as long as any of them do
+    if (header.format == Format::BC1)
+    {
+        std::shared_ptr<const uint64_t[]> pBlocks;
+        if (!placeholder)
+            pBlocks = std::shared_ptr<const uint64_t[]>(pFile, reinterpret_cast<const uint64_t*>(pLevel));
+        compressedLevels.emplace_back(w, h, std::move(pBlocks));
+    }
+    else
+    {
+        std::shared_ptr<unsigned int[]> pPixels;
+        if (!placeholder)
+            pPixels = std::shared_ptr<unsigned int[]>(pFile, reinterpret_cast<unsigned int*>(pLevel));
+        levels.emplace_back(w, h, static_cast<Surface::Layout>(header.layout), std::move(pPixels));
+    }
+}
@@ -0,0 +1,99 @@
+//
+//  TextureFile.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef TextureFile_hpp
+#define TextureFile_hpp
+
+#include <string>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include "Graphics.hpp"
+#include "Texture.hpp"
+#include "MappedFile.hpp"
+
+// reads and writes textures in a preprocessed binary format that holds every level exactly as it
+// is laid out in memory for sampling - loading levels memory-maps the file and points them
+// straight at the mapped data, so there is nothing to parse or convert
+// levels are loaded a few at a time, for streaming (see TextureResidency) - a level's memory is
+// given back as soon as nothing uses it
+// (files are in native byte order, as they are a cache rather than an interchange format)
+class TextureFile
+{
+public:
+    class Exception : public Graphics::Exception
+    {
+    public:
+        Exception(std::string filename, std::string msg);
+        std::string GetMsg() const override;
+    private:
+        std::string filename;
+        std::string msg;
+    };
+    
+    TextureFile() = delete;
+    static void Save(const std::string& filename, const Texture& t);
+    // (re)builds the cache for an image if needed, returning whether there is a usable one -
+    // compressed textures (see Texture::Compress()) have a cache of their own
+    static bool UpdateCache(const std::string& imageFilename, bool compressed = false);
+    static std::string CacheFilename(const std::string& imageFilename, bool compressed = false);
+    // reads only the coarsest levels, up to the given size (and at least the smallest level) -
+    // the finer levels are left out, to be read later with LoadLevel()
+    static Texture LoadTail(const std::string& filename, size_t tailBytes);
+    // reads a single level, as a texture of its own
+    static Texture LoadLevel(const std::string& filename, int level);
+    ~TextureFile() = delete;
+    
+private:
+    enum class Format : uint32_t
+    {
+        ARGB8888,
+        BC1
+    };
+    
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t numLevels;
+        Format format;
+        uint32_t layout; // (a Surface::Layout)
+        uint32_t reserved;
+        uint64_t contentHash;
+    };
+    
+    // (one of these follows the header for each level)
+    struct LevelEntry
+    {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset; // from the beginning of the file
+        uint64_t size;
+    };
+    
+    static bool IsCacheCurrent(const std::string& imageFilename, const std::string& cacheFilename);
+    static void CheckHeader(const std::string& filename, const Header& header, uint64_t fileSize);
+    static void CheckLevel(const std::string& filename, const Header& header, const LevelEntry& e, uint64_t fileSize);
+    // maps a texture file, reading and checking its header and level table
+    static std::shared_ptr<MappedFile> Map(const std::string& filename, Header& header, std::vector<LevelEntry>& entries);
+    // adds a level of a mapped file to whichever of the lists matches the file's format (or, if
+    // placeholder is set, a level with the right dimensions but no texels)
+    static void AddLevel(const std::shared_ptr<MappedFile>& pFile, const Header& header, const LevelEntry& e,
+                         bool placeholder, std::vector<Surface>& levels, std::vector<BC1Surface>& compressedLevels);
+    
+    static constexpr char Magic[4] = { 'E', '3', 'D', 'T' };
+    static constexpr uint32_t Version = 3;
+    // level data is aligned to cache lines
+    static constexpr uint64_t DataAlignment = 64;
+    // (at most the size of a page of memory, on anything this runs on)
+    static constexpr uint64_t PageSize = 4096;
+};
+
+#endif /* TextureFile_hpp */
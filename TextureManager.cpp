@@ -0,0 +1,149 @@
+//
+//  TextureManager.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <filesystem>
+#include <unordered_set>
+#include <limits>
+#include "TextureManager.hpp"
+#include "TextureFile.hpp"
+#include "TextureResidency.hpp"
+
+TextureManager& TextureManager::Get()
+{
+    static TextureManager tm;
+    return tm;
+}
+
+std::shared_ptr<const Texture> TextureManager::Load(const std::string& filename, bool compressed)
+{
+    // different spellings of the same path should find the same texture
+    std::error_code ec;
+    std::string path = std::filesystem::weakly_canonical(filename, ec).string();
+    if (ec)
+        path = filename;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = texturesByPath[compressed].find(path);
+        if (it != texturesByPath[compressed].end())
+            if (auto pTexture = it->second.lock())
+                return pTexture;
+    }
+    
+    // load without holding the lock, so that other textures can be loaded at the same time
+    // textures with a cache file start out with just their coarsest levels, and have the finer
+    // ones streamed in as needed (see TextureResidency) - otherwise the whole texture is loaded
+    std::shared_ptr<Texture> pTexture;
+    bool streamed = false;
+    const std::string cacheFilename = TextureFile::CacheFilename(filename, compressed);
+    if (TextureFile::UpdateCache(filename, compressed))
+    {
+        try
+        {
+            pTexture = std::make_shared<Texture>(TextureFile::LoadTail(cacheFilename, TextureResidency::TailBytes));
+            streamed = true;
+        }
+        catch (const TextureFile::Exception&)
+        {
+        }
+    }
+    if (!pTexture)
+    {
+        pTexture = std::make_shared<Texture>(Graphics::LoadTexture(filename));
+        if (compressed)
+            pTexture->Compress();
+    }
+    uint64_t hash = pTexture->GetContentHash();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    Purge();
+    
+    // (someone else may have loaded the same file, or the same contents, in the meantime - the
+    // hash only says that the contents are probably the same, so the texels themselves are
+    // compared to make sure, which is rare enough to be done while holding the lock)
+    const std::string streamedFrom = streamed ? cacheFilename : std::string();
+    auto itHash = texturesByHash[compressed].find(hash);
+    bool hashTaken = false;
+    if (itHash != texturesByHash[compressed].end())
+    {
+        if (auto pExisting = itHash->second.pTexture.lock())
+        {
+            if (SameTexels(*pExisting, itHash->second.cacheFilename, *pTexture, streamedFrom))
+            {
+                texturesByPath[compressed][path] = pExisting;
+                return pExisting;
+            }
+            // (a different image that happens to have the same hash - it's kept separate, and
+            // just isn't found by hash itself)
+            hashTaken = true;
+        }
+    }
+    
+    texturesByPath[compressed][path] = pTexture;
+    if (!hashTaken)
+        texturesByHash[compressed][hash] = { pTexture, streamedFrom };
+    if (streamed)
+        TextureResidency::Get().Add(pTexture, cacheFilename);
+    return pTexture;
+}
+
+size_t TextureManager::GetResidentBytes()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    // (a texture may be listed under more than one path, but should only be counted once)
+    std::unordered_set<const Texture*> counted;
+    size_t size = 0;
+    for (const auto& byHash : texturesByHash)
+        for (const auto& entry : byHash)
+            if (auto pTexture = entry.second.pTexture.lock())
+                if (counted.insert(pTexture.get()).second)
+                    size += pTexture->SizeBytes();
+    return size;
+}
+
+size_t TextureManager::GetNumTextures()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Purge();
+    return texturesByHash[0].size() + texturesByHash[1].size();
+}
+
+// forgets about textures that are no longer in use
+void TextureManager::Purge()
+{
+    for (auto& byPath : texturesByPath)
+        for (auto it = byPath.begin(); it != byPath.end(); )
+            it = it->second.expired() ? byPath.erase(it) : std::next(it);
+    for (auto& byHash : texturesByHash)
+        for (auto it = byHash.begin(); it != byHash.end(); )
+            it = it->second.pTexture.expired() ? byHash.erase(it) : std::next(it);
+}
+
+// whether two textures with the same hash really are the same - a streamed texture's levels are
+// read from its cache file for this, as they aren't all in memory (and the ones that are can
+// change at any moment - see TextureResidency)
+bool TextureManager::SameTexels(const Texture& a, const std::string& aCacheFilename,
+                                const Texture& b, const std::string& bCacheFilename)
+{
+    try
+    {
+        std::unique_ptr<Texture> pWholeA;
+        std::unique_ptr<Texture> pWholeB;
+        if (!aCacheFilename.empty())
+            pWholeA = std::make_unique<Texture>(TextureFile::LoadTail(aCacheFilename, std::numeric_limits<size_t>::max()));
+        if (!bCacheFilename.empty())
+            pWholeB = std::make_unique<Texture>(TextureFile::LoadTail(bCacheFilename, std::numeric_limits<size_t>::max()));
+        return (pWholeA ? *pWholeA : a).SameTexels(pWholeB ? *pWholeB : b);
+    }
+    catch (const TextureFile::Exception&)
+    {
+        // (if they can't be compared, they're taken to be different, which is always safe)
+        return false;
+    }
+}
@@ -0,0 +1,61 @@
+//
+//  TextureManager.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef TextureManager_hpp
+#define TextureManager_hpp
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "Texture.hpp"
+
+// hands out shared, read-only textures - a texture is only loaded once however many effects use
+// it, and is freed when the last user lets go of it
+// textures are looked up by file path, and textures that turn out to have identical contents
+// (e.g. copies of the same image under different names) are also merged into one - the content
+// hash is stored in the texture cache, so finding a possible match doesn't require reading every
+// texel (only making sure of one does)
+// a texture can also be loaded compressed (see Texture::Compress()) - the compressed and
+// uncompressed versions of an image are separate textures, and are never merged
+// (safe to use from multiple threads - and a texture handed out can be sampled from any number of
+// threads at once, as what sampling writes, i.e. the requested level and the compressed block
+// cache, is atomic or per thread)
+class TextureManager
+{
+public:
+    TextureManager(const TextureManager&) = delete;
+    TextureManager& operator=(const TextureManager&) = delete;
+    static TextureManager& Get();
+    std::shared_ptr<const Texture> Load(const std::string& filename, bool compressed = false);
+    // total size of all textures currently in use (counting only the levels in memory)
+    size_t GetResidentBytes();
+    size_t GetNumTextures();
+    
+private:
+    TextureManager() = default;
+    ~TextureManager() = default;
+    // (along with the cache file a texture's levels are streamed from - empty if it isn't streamed)
+    struct HashedTexture
+    {
+        std::weak_ptr<const Texture> pTexture;
+        std::string cacheFilename;
+    };
+    
+    void Purge();
+    static bool SameTexels(const Texture& a, const std::string& aCacheFilename,
+                           const Texture& b, const std::string& bCacheFilename);
+    
+    std::mutex mutex;
+    // (weak references, so that the manager itself doesn't keep textures alive - and indexed by
+    // whether the textures are compressed)
+    std::unordered_map<std::string, std::weak_ptr<const Texture>> texturesByPath[2];
+    std::unordered_map<uint64_t, HashedTexture> texturesByHash[2];
+};
+
+#endif /* TextureManager_hpp */
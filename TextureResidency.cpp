@@ -0,0 +1,246 @@
+//
+//  TextureResidency.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include "TextureResidency.hpp"
+#include "TextureFile.hpp"
+
+TextureResidency::TextureResidency():
+    worker(&TextureResidency::Worker, this)
+{
+}
+
+TextureResidency::~TextureResidency()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        quit = true;
+    }
+    jobCondition.notify_one();
+    worker.join();
+}
+
+TextureResidency& TextureResidency::Get()
+{
+    static TextureResidency tr;
+    return tr;
+}
+
+void TextureResidency::Add(std::shared_ptr<Texture> pTexture, std::string filename)
+{
+    // the tail is the coarsest levels that fit in the tail size (but always at least the
+    // smallest level)
+    int tailLevel = pTexture->NumLevels() - 1;
+    size_t tailSize = pTexture->LevelSizeBytes(tailLevel);
+    while (tailLevel > 0 && tailSize + pTexture->LevelSizeBytes(tailLevel - 1) <= TailBytes)
+        tailSize += pTexture->LevelSizeBytes(--tailLevel);
+
+    Entry e;
+    e.pTexture = pTexture;
+    e.filename = std::move(filename);
+    e.tailLevel = tailLevel;
+    e.wantedLevel = tailLevel;
+    e.lastUsedFrame = 0;
+    e.residentBytes = 0;
+    for (int i = pTexture->GetResidentLevel(); i < tailLevel; i++)
+        e.residentBytes += pTexture->LevelSizeBytes(i);
+    e.loading = false;
+    e.failed = false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // (the entry of a texture that has since been freed may not have been cleared up yet)
+    auto it = entries.find(pTexture.get());
+    if (it != entries.end())
+        residentBytes -= it->second.residentBytes;
+
+    residentBytes += e.residentBytes;
+    entries[pTexture.get()] = std::move(e);
+}
+
+void TextureResidency::SetBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    budget = bytes;
+}
+
+size_t TextureResidency::GetResidentBytes()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return residentBytes;
+}
+
+void TextureResidency::Update()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    frame++;
+
+    // fill in the levels that have been read in since last time
+    std::vector<Result> finished;
+    {
+        std::lock_guard<std::mutex> jobLock(jobMutex);
+        finished.swap(results);
+    }
+    for (auto& r : finished)
+    {
+        loadingBytes -= r.size;
+
+        auto pTexture = r.pTexture.lock();
+        auto it = entries.find(pTexture.get());
+        if (!pTexture || it == entries.end() || it->second.pTexture.lock() != pTexture)
+            continue;
+
+        // (if a level can't be read, the texture just carries on with the levels it has)
+        Entry& e = it->second;
+        e.loading = false;
+        if (!r.pLevel)
+            e.failed = true;
+        else if (pTexture->GetResidentLevel() == r.level + 1)
+        {
+            pTexture->RestoreLevel(std::move(*r.pLevel));
+            e.residentBytes += r.size;
+            residentBytes += r.size;
+        }
+    }
+
+    // find out which levels sampling asked for, and forget about textures that are gone
+    for (auto it = entries.begin(); it != entries.end(); )
+    {
+        auto pTexture = it->second.pTexture.lock();
+        if (!pTexture)
+        {
+            residentBytes -= it->second.residentBytes;
+            it = entries.erase(it);
+            continue;
+        }
+
+        int level = pTexture->TakeRequestedLevel();
+        if (level < pTexture->NumLevels())
+        {
+            it->second.wantedLevel = level;
+            it->second.lastUsedFrame = frame;
+        }
+        ++it;
+    }
+
+    // (in case the budget has been lowered)
+    while (residentBytes + loadingBytes > budget && EvictOne(UINT64_MAX))
+        ;
+
+    // read in the next finer level of each texture that wants one, most recently used first -
+    // making room by evicting levels of textures that have been used less recently
+    std::vector<Entry*> wanting;
+    for (auto& entry : entries)
+    {
+        Entry& e = entry.second;
+        if (!e.loading && !e.failed && e.wantedLevel < e.pTexture.lock()->GetResidentLevel())
+            wanting.push_back(&e);
+    }
+    std::sort(wanting.begin(), wanting.end(), [](const Entry* pE1, const Entry* pE2)
+    {
+        return pE1->lastUsedFrame > pE2->lastUsedFrame;
+    });
+
+    std::vector<Job> newJobs;
+    for (Entry* pE : wanting)
+    {
+        auto pTexture = pE->pTexture.lock();
+        int level = pTexture->GetResidentLevel() - 1;
+        size_t size = pTexture->LevelSizeBytes(level);
+        while (residentBytes + loadingBytes + size > budget && EvictOne(pE->lastUsedFrame))
+            ;
+
+        // (anything else would mean evicting something at least as recently used)
+        if (residentBytes + loadingBytes + size > budget)
+            break;
+
+        pE->loading = true;
+        loadingBytes += size;
+        newJobs.push_back({ pTexture, pE->filename, level, size });
+    }
+
+    if (!newJobs.empty())
+    {
+        {
+            std::lock_guard<std::mutex> jobLock(jobMutex);
+            for (auto& job : newJobs)
+                jobs.push_back(std::move(job));
+        }
+        jobCondition.notify_one();
+    }
+}
+
+// evicts the finest level of the texture least in need of it - levels finer than a texture has
+// recently asked for go first, then levels of textures last used before the given frame, least
+// recently used first
+// (returns false if there was nothing to evict)
+bool TextureResidency::EvictOne(uint64_t usedBefore)
+{
+    Entry* pVictim = nullptr;
+    bool victimUnwanted = false;
+    for (auto& entry : entries)
+    {
+        Entry& e = entry.second;
+        auto pTexture = e.pTexture.lock();
+        if (e.loading || !pTexture || pTexture->GetResidentLevel() >= e.tailLevel)
+            continue;
+
+        bool unwanted = pTexture->GetResidentLevel() < e.wantedLevel;
+        if (!unwanted && e.lastUsedFrame >= usedBefore)
+            continue;
+
+        if (!pVictim || (unwanted && !victimUnwanted) ||
+            (unwanted == victimUnwanted && e.lastUsedFrame < pVictim->lastUsedFrame))
+        {
+            pVictim = &e;
+            victimUnwanted = unwanted;
+        }
+    }
+
+    if (!pVictim)
+        return false;
+
+    auto pTexture = pVictim->pTexture.lock();
+    size_t size = pTexture->LevelSizeBytes(pTexture->GetResidentLevel());
+    pTexture->EvictLevel();
+    pVictim->residentBytes -= size;
+    residentBytes -= size;
+    return true;
+}
+
+// reads levels in, one at a time
+void TextureResidency::Worker()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobCondition.wait(lock, [this]() { return quit || !jobs.empty(); });
+            if (quit)
+                return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        Result r{ job.pTexture, job.level, job.size, nullptr };
+        if (!job.pTexture.expired())
+        {
+            try
+            {
+                r.pLevel = std::make_unique<Texture>(TextureFile::LoadLevel(job.filename, job.level));
+            }
+            catch (const TextureFile::Exception&)
+            {
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(jobMutex);
+        results.push_back(std::move(r));
+    }
+}
@@ -0,0 +1,98 @@
+//
+//  TextureResidency.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef TextureResidency_hpp
+#define TextureResidency_hpp
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Texture.hpp"
+
+// keeps the memory used by the finer mip levels of textures within a budget
+// every texture keeps a small tail of its coarsest levels in memory at all times - finer levels
+// are read in from the texture's cache file on a background thread as sampling asks for them,
+// and the levels of the least recently sampled textures are evicted to make room
+// until a level has been read in, sampling uses the finest level that is, so a missing level
+// never holds up a frame
+// textures are added by TextureManager - Update() should be called once per frame, between
+// frames, as that is the only time the levels of textures change
+class TextureResidency
+{
+public:
+    // the coarsest levels of each texture, up to this size, are never evicted
+    static constexpr size_t TailBytes = 16 * 1024;
+    static constexpr size_t DefaultBudgetBytes = 64 * 1024 * 1024;
+    
+    TextureResidency(const TextureResidency&) = delete;
+    TextureResidency& operator=(const TextureResidency&) = delete;
+    static TextureResidency& Get();
+    // (levels are read from the given texture file, which the texture must have been loaded from)
+    void Add(std::shared_ptr<Texture> pTexture, std::string filename);
+    void SetBudget(size_t bytes);
+    void Update();
+    // size of the levels outside of the tails (which is what the budget covers)
+    size_t GetResidentBytes();
+    
+private:
+    struct Entry
+    {
+        std::weak_ptr<Texture> pTexture;
+        std::string filename;
+        int tailLevel;
+        int wantedLevel;
+        uint64_t lastUsedFrame;
+        size_t residentBytes;
+        bool loading;
+        bool failed;
+    };
+    
+    struct Job
+    {
+        std::weak_ptr<Texture> pTexture;
+        std::string filename;
+        int level;
+        size_t size;
+    };
+    
+    struct Result
+    {
+        std::weak_ptr<Texture> pTexture;
+        int level;
+        size_t size;
+        std::unique_ptr<Texture> pLevel; // (null if the level couldn't be read)
+    };
+    
+    TextureResidency();
+    ~TextureResidency();
+    bool EvictOne(uint64_t usedBefore);
+    void Worker();
+    
+    std::mutex mutex;
+    std::unordered_map<const Texture*, Entry> entries;
+    size_t budget = DefaultBudgetBytes;
+    size_t residentBytes = 0;
+    size_t loadingBytes = 0;
+    uint64_t frame = 0;
+    
+    // (shared with the worker thread)
+    std::mutex jobMutex;
+    std::condition_variable jobCondition;
+    std::deque<Job> jobs;
+    std::vector<Result> results;
+    bool quit = false;
+    std::thread worker;
+};
+
+#endif /* TextureResidency_hpp */
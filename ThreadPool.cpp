@@ -0,0 +1,50 @@
+//
+//  ThreadPool.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+{
+    if (numThreads == 0)
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    
+    for (unsigned int i = 0; i < numThreads; i++)
+        workers.emplace_back(&ThreadPool::Worker, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    condition.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void ThreadPool::Worker()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return quit || !tasks.empty(); });
+            
+            // (only stop once there is nothing left to do)
+            if (tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        
+        task();
+    }
+}
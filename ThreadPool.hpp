@@ -0,0 +1,59 @@
+//
+//  ThreadPool.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+// runs tasks on a fixed set of worker threads
+// each task's result (or the exception it threw) is handed back through a future
+class ThreadPool
+{
+public:
+    // (by default, one thread per hardware thread)
+    ThreadPool(unsigned int numThreads = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    template <typename F>
+    auto Submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        
+        // (packaged tasks can't be copied, but std::function needs something that can be)
+        auto pTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+        std::future<Result> future = pTask->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back([pTask]() { (*pTask)(); });
+        }
+        condition.notify_one();
+        return future;
+    }
+    // (waits for any tasks already submitted to finish)
+    ~ThreadPool();
+    
+private:
+    void Worker();
+    
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> tasks;
+    bool quit = false;
+    std::vector<std::thread> workers;
+};
+
+#endif /* ThreadPool_hpp */
@@ -9,10 +9,16 @@
 #ifndef Vec3_hpp
 #define Vec3_hpp
 
+#include <type_traits>
 #include "Vec2.hpp"
+#include "Simd.hpp"
 
+// 3 components, padded out to 4 (and aligned to match) - a float vector fills exactly one SSE
+// register, so the operators below are a handful of instructions each
+// (the SIMD versions do the same float operations, in the same order, as the plain versions -
+// so the results are identical, whichever is used)
 template<typename T>
-class _Vec3 : public _Vec2<T>
+class alignas(4 * sizeof(T)) _Vec3 : public _Vec2<T>
 {
 public:
     _Vec3() = default;
@@ -20,15 +26,12 @@ public:
         _Vec2<T>(x, y),
         z(z)
     {}
-    _Vec3& operator=(const _Vec3& rhs)
-    {
-        x = rhs.x;
-        y = rhs.y;
-        z = rhs.z;
-        return *this;
-    }
     _Vec3 operator+(const _Vec3& rhs) const
     {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+            return FromSimd(_mm_add_ps(ToSimd(), rhs.ToSimd()));
+#endif
         return _Vec3(x + rhs.x, y + rhs.y, z + rhs.z);
     }
     _Vec3& operator+=(const _Vec3& rhs)
@@ -38,6 +41,10 @@ public:
     }
     _Vec3 operator-(const _Vec3& rhs) const
     {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+            return FromSimd(_mm_sub_ps(ToSimd(), rhs.ToSimd()));
+#endif
         return _Vec3(x - rhs.x, y - rhs.y, z - rhs.z);
     }
     _Vec3& operator-=(const _Vec3& rhs)
@@ -45,12 +52,16 @@ public:
         *this = *this - rhs;
         return *this;
     }
-    _Vec3& operator-() const
+    _Vec3 operator-() const
     {
         return (*this * static_cast<T>(-1));
     }
     _Vec3 operator*(const T& rhs) const
     {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+            return FromSimd(_mm_mul_ps(ToSimd(), _mm_set1_ps(rhs)));
+#endif
         return _Vec3(x * rhs, y * rhs, z * rhs);
     }
     _Vec3& operator*=(const T& rhs)
@@ -60,26 +71,52 @@ public:
     }
     _Vec3 operator/(const T& rhs) const
     {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+            return FromSimd(_mm_div_ps(ToSimd(), _mm_set1_ps(rhs)));
+#endif
         return _Vec3(x / rhs, y / rhs, z / rhs);
     }
-    _Vec3& operator/=(const _Vec3& rhs)
+    _Vec3& operator/=(const T& rhs)
     {
         *this = *this / rhs;
         return *this;
     }
     T operator*(const _Vec3& rhs) const // dot product
     {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+        {
+            // (summed as x + y, then + z - the same as below)
+            __m128 m = _mm_mul_ps(ToSimd(), rhs.ToSimd());
+            __m128 sum = _mm_add_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+            return _mm_cvtss_f32(_mm_add_ss(sum, _mm_movehl_ps(m, m)));
+        }
+#endif
         return (x * rhs.x + y * rhs.y + z * rhs.z);
     }
     _Vec3 cross(const _Vec3& rhs) const // cross product
     {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+        {
+            // (yzx * zxy - zxy * yzx)
+            __m128 a = ToSimd();
+            __m128 b = rhs.ToSimd();
+            __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 aZXY = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+            __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 bZXY = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+            return FromSimd(_mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX)));
+        }
+#endif
         return _Vec3(y * rhs.z - z * rhs.y,
              z * rhs.x - x * rhs.z,
              x * rhs.y - y * rhs.x);
     }
     T MagSq() const
     {
-        return (x*x + y*y + z*z);
+        return (*this * *this);
     }
     T Mag() const
     {
@@ -87,15 +124,27 @@ public:
     }
     _Vec3 Norm() const
     {
-        T mag = Mag();
-        return _Vec3(x/mag, y/mag, z/mag);
+        return (*this / Mag());
     }
     _Vec3 InterpTo(const _Vec3& rhs, T percent) const
     {
         return (*this + (rhs - *this) * percent);
     }
     ~_Vec3() = default;
-    
+
+#ifdef SIMD_SSE2
+    static constexpr bool IsSimd = std::is_same<T, float>::value;
+
+    // (only for float vectors)
+    __m128 ToSimd() const { return _mm_load_ps(&x); }
+    static _Vec3 FromSimd(__m128 v)
+    {
+        _Vec3 res;
+        _mm_store_ps(&res.x, v);
+        return res;
+    }
+#endif
+
 public:
     // these usings are due to a strange issue described at:
     // https://stackoverflow.com/questions/6592512/templates-parent-class-member-variables-not-visible-in-inherited-class
@@ -103,8 +152,13 @@ public:
     using _Vec2<T>::x;
     using _Vec2<T>::y;
     T z;
+
+private:
+    // (fills out the 4th lane - its value is never used)
+    T pad = static_cast<T>(0);
 };
 
 typedef _Vec3<float> Vec3;
+static_assert(sizeof(Vec3) == 4 * sizeof(float), "Vec3 must fill exactly 4 floats");
 
 #endif /* Vec3_hpp */
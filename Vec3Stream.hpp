@@ -0,0 +1,44 @@
+//
+//  Vec3Stream.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef Vec3Stream_hpp
+#define Vec3Stream_hpp
+
+#include <vector>
+#include "Vec3.hpp"
+
+// a run of vectors stored as a structure of arrays - all the x components, then all the y
+// components, then all the z components - so that batch operations (see VertexTransform) can
+// load the same component of several vectors at once
+class Vec3Stream
+{
+public:
+    size_t Size() const { return x.size(); }
+    void Resize(size_t n)
+    {
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+    }
+    void Set(size_t i, const Vec3& v)
+    {
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+    Vec3 Get(size_t i) const
+    {
+        return Vec3(x[i], y[i], z[i]);
+    }
+    
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+};
+
+#endif /* Vec3Stream_hpp */
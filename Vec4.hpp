@@ -0,0 +1,117 @@
+//
+//  Vec4.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef Vec4_hpp
+#define Vec4_hpp
+
+#include <type_traits>
+#include "Vec3.hpp"
+#include "Simd.hpp"
+
+// a homogeneous vector - a point (w = 1) or direction (w = 0) that can be transformed by a Mat4
+// (as with Vec3, a float vector is one SSE register)
+template<typename T>
+class alignas(4 * sizeof(T)) _Vec4
+{
+public:
+    _Vec4() = default;
+    _Vec4(T x, T y, T z, T w):
+        x(x),
+        y(y),
+        z(z),
+        w(w)
+    {}
+    _Vec4(const _Vec3<T>& v, T w):
+        x(v.x),
+        y(v.y),
+        z(v.z),
+        w(w)
+    {}
+    _Vec4 operator+(const _Vec4& rhs) const
+    {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+            return FromSimd(_mm_add_ps(ToSimd(), rhs.ToSimd()));
+#endif
+        return _Vec4(x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w);
+    }
+    _Vec4& operator+=(const _Vec4& rhs)
+    {
+        *this = *this + rhs;
+        return *this;
+    }
+    _Vec4 operator-(const _Vec4& rhs) const
+    {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+            return FromSimd(_mm_sub_ps(ToSimd(), rhs.ToSimd()));
+#endif
+        return _Vec4(x - rhs.x, y - rhs.y, z - rhs.z, w - rhs.w);
+    }
+    _Vec4& operator-=(const _Vec4& rhs)
+    {
+        *this = *this - rhs;
+        return *this;
+    }
+    _Vec4 operator*(const T& rhs) const
+    {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+            return FromSimd(_mm_mul_ps(ToSimd(), _mm_set1_ps(rhs)));
+#endif
+        return _Vec4(x * rhs, y * rhs, z * rhs, w * rhs);
+    }
+    _Vec4& operator*=(const T& rhs)
+    {
+        *this = *this * rhs;
+        return *this;
+    }
+    _Vec4 operator/(const T& rhs) const
+    {
+#ifdef SIMD_SSE2
+        if constexpr (IsSimd)
+            return FromSimd(_mm_div_ps(ToSimd(), _mm_set1_ps(rhs)));
+#endif
+        return _Vec4(x / rhs, y / rhs, z / rhs, w / rhs);
+    }
+    _Vec4& operator/=(const T& rhs)
+    {
+        *this = *this / rhs;
+        return *this;
+    }
+    T operator*(const _Vec4& rhs) const // dot product
+    {
+        return (x * rhs.x + y * rhs.y + z * rhs.z + w * rhs.w);
+    }
+    // (drops w - e.g. after dividing through by it)
+    _Vec3<T> XYZ() const
+    {
+        return _Vec3<T>(x, y, z);
+    }
+    ~_Vec4() = default;
+
+#ifdef SIMD_SSE2
+    static constexpr bool IsSimd = std::is_same<T, float>::value;
+
+    // (only for float vectors)
+    __m128 ToSimd() const { return _mm_load_ps(&x); }
+    static _Vec4 FromSimd(__m128 v)
+    {
+        _Vec4 res;
+        _mm_store_ps(&res.x, v);
+        return res;
+    }
+#endif
+
+public:
+    T x, y, z, w;
+};
+
+typedef _Vec4<float> Vec4;
+
+#endif /* Vec4_hpp */
@@ -11,13 +11,15 @@
 
 #include "Vec3.hpp"
 #include "Color.hpp"
+#include "Interpolants.hpp"
+#include "ColorPixelShader.hpp"
 
 // colors are assigned to vertices and interpolated between them screen-linearly
 // no lighting effects
 class VertexColorEffect
 {
 public:
-    // includes an attribute for color, which is interpolated
+    // a position and color
     class Vertex
     {
     public:
@@ -27,67 +29,23 @@ public:
             c(c)
         {
         }
-        Vertex& operator=(const Vertex& rhs)
-        {
-            v = rhs.v;
-            c = rhs.c;
-            return *this;
-        }
-        Vertex operator+(const Vertex& rhs) const
-        {
-            return Vertex(v + rhs.v, c + rhs.c);
-        }
-        Vertex& operator+=(const Vertex& rhs)
-        {
-            *this = *this + rhs;
-            return *this;
-        }
-        Vertex operator-(const Vertex& rhs) const
-        {
-            return Vertex(v - rhs.v, c - rhs.c);
-        }
-        Vertex& operator-=(const Vertex& rhs)
-        {
-            *this = *this - rhs;
-            return *this;
-        }
-        Vertex operator*(float rhs) const
-        {
-            return Vertex(v * rhs, c * rhs);
-        }
-        Vertex& operator*=(float rhs)
-        {
-            *this = *this * rhs;
-            return *this;
-        }
-        Vertex operator/(float rhs) const
-        {
-            return Vertex(v / rhs, c / rhs);
-        }
-        Vertex& operator/=(float rhs)
-        {
-            *this = *this / rhs;
-            return *this;
-        }
-        Vertex InterpTo(const Vertex& rhs, float percent) const
-        {
-            return { v.InterpTo(rhs.v, percent),
-                c.InterpTo(rhs.c, percent) };
-        }
         
         Vec3 v;
         Vec3 c; // color
     };
     
+    // the attributes interpolated across triangles (see Interpolants)
+    enum Attribute { R, G, B, NumAttributes };
+    
     // only handles rotation and translation
     class VertexShader
     {
     public:
-        typedef Vertex OutVertex;
+        typedef InterpolatedVertex<NumAttributes> OutVertex;
         
         OutVertex operator()(const Vertex& vertex)
         {
-            return OutVertex(vertex.v * rotMat + transVec, vertex.c);
+            return OutVertex(vertex.v * rotMat + transVec, { vertex.c.x, vertex.c.y, vertex.c.z });
         };
         void BindRotation(const Mat3& rotMat)
         {
@@ -108,6 +66,7 @@ public:
     {
     public:
         typedef VertexShader::OutVertex OutVertex;
+        static constexpr bool PassThrough = true;
         
         Triangle<GeometryShader::OutVertex> operator()(const Triangle<VertexShader::OutVertex>& t)
         {
@@ -115,16 +74,8 @@ public:
         }
     };
 
-    class PixelShader
-    {
-    public:
-        Color operator()(const Vertex& vertex)
-        {
-            return Color(vertex.c);
-        };
-        
-    private:
-    };
+    // (the vertex colors, interpolated - see ColorPixelShader)
+    typedef ColorPixelShader<NumAttributes, R> PixelShader;
     
     VertexShader vertexShader;
     GeometryShader geometryShader;
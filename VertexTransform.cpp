@@ -0,0 +1,103 @@
+//
+//  VertexTransform.cpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#include "VertexTransform.hpp"
+#include "Simd.hpp"
+
+void VertexTransform::Transform(const Vec3Stream& in, const Mat3& rotMat, const Vec3& transVec, Vec3Stream& out)
+{
+    Apply<true>(in, rotMat, transVec, out);
+}
+
+void VertexTransform::Rotate(const Vec3Stream& in, const Mat3& rotMat, Vec3Stream& out)
+{
+    Apply<false>(in, rotMat, Vec3(0.0f, 0.0f, 0.0f), out);
+}
+
+// each output component is (x * m[0][c] + y * m[1][c]) + z * m[2][c] (+ t[c]) - the vector
+// versions work out the same sums for several vectors at once, with each matrix element
+// broadcast across a register
+template <bool Translate>
+void VertexTransform::Apply(const Vec3Stream& in, const Mat3& rotMat, const Vec3& transVec, Vec3Stream& out)
+{
+    const int n = static_cast<int>(in.Size());
+    out.Resize(in.Size());
+    const float* pX = in.x.data();
+    const float* pY = in.y.data();
+    const float* pZ = in.z.data();
+    float* pOut[3] = { out.x.data(), out.y.data(), out.z.data() };
+    const float t[3] = { transVec.x, transVec.y, transVec.z };
+    
+    int i = 0;
+#if SIMD_AVX2
+    {
+        __m256 m[3][3];
+        __m256 tv[3];
+        for (int c = 0; c < 3; c++)
+        {
+            for (int r = 0; r < 3; r++)
+                m[r][c] = _mm256_set1_ps(rotMat.data[r][c]);
+            tv[c] = _mm256_set1_ps(t[c]);
+        }
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(pX + i);
+            __m256 y = _mm256_loadu_ps(pY + i);
+            __m256 z = _mm256_loadu_ps(pZ + i);
+            for (int c = 0; c < 3; c++)
+            {
+                __m256 res = _mm256_add_ps(_mm256_mul_ps(x, m[0][c]), _mm256_mul_ps(y, m[1][c]));
+                res = _mm256_add_ps(res, _mm256_mul_ps(z, m[2][c]));
+                if constexpr (Translate)
+                    res = _mm256_add_ps(res, tv[c]);
+                _mm256_storeu_ps(pOut[c] + i, res);
+            }
+        }
+    }
+#endif
+#if SIMD_SSE2
+    {
+        __m128 m[3][3];
+        __m128 tv[3];
+        for (int c = 0; c < 3; c++)
+        {
+            for (int r = 0; r < 3; r++)
+                m[r][c] = _mm_set1_ps(rotMat.data[r][c]);
+            tv[c] = _mm_set1_ps(t[c]);
+        }
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(pX + i);
+            __m128 y = _mm_loadu_ps(pY + i);
+            __m128 z = _mm_loadu_ps(pZ + i);
+            for (int c = 0; c < 3; c++)
+            {
+                __m128 res = _mm_add_ps(_mm_mul_ps(x, m[0][c]), _mm_mul_ps(y, m[1][c]));
+                res = _mm_add_ps(res, _mm_mul_ps(z, m[2][c]));
+                if constexpr (Translate)
+                    res = _mm_add_ps(res, tv[c]);
+                _mm_storeu_ps(pOut[c] + i, res);
+            }
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        // (read everything before writing anything, in case the output is the input)
+        float x = pX[i];
+        float y = pY[i];
+        float z = pZ[i];
+        for (int c = 0; c < 3; c++)
+        {
+            float res = x * rotMat.data[0][c] + y * rotMat.data[1][c] + z * rotMat.data[2][c];
+            if constexpr (Translate)
+                res += t[c];
+            pOut[c][i] = res;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+//
+//  VertexTransform.hpp
+//  engine3d
+//
+//  Created by Brian Dolan on 10/19/26.
+//  Copyright © 2026 Brian Dolan. All rights reserved.
+//
+
+#ifndef VertexTransform_hpp
+#define VertexTransform_hpp
+
+#include "Vec3.hpp"
+#include "Mat3.hpp"
+#include "Vec3Stream.hpp"
+
+// transforms whole streams of vectors by the same matrix - several vectors at once (8 with
+// AVX2, 4 with SSE2), for batched vertex shaders
+// results match transforming each vector with Vec3/Mat3's operators exactly, whichever
+// instruction set is used
+// (the output is resized to match the input, and may be the same stream)
+class VertexTransform
+{
+public:
+    VertexTransform() = delete;
+    ~VertexTransform() = delete;
+    
+    // v * rotMat + transVec, e.g. for positions
+    static void Transform(const Vec3Stream& in, const Mat3& rotMat, const Vec3& transVec, Vec3Stream& out);
+    // v * rotMat, e.g. for normals (which must not be translated)
+    static void Rotate(const Vec3Stream& in, const Mat3& rotMat, Vec3Stream& out);
+    
+private:
+    template <bool Translate>
+    static void Apply(const Vec3Stream& in, const Mat3& rotMat, const Vec3& transVec, Vec3Stream& out);
+};
+
+#endif /* VertexTransform_hpp */